@@ -0,0 +1,98 @@
+// MpmcQueue throughput with 1..N producers and 1..N consumers.
+// Build on Linux: g++ -O2 -std=c++11 -DOSAPI_USE_POSIX -I.. bench_mpmc_queue.cpp ../linux/osapi_linux.cpp -pthread
+// Usage: bench_mpmc_queue [max threads per side] [items]
+#include "osapi.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace osapi;
+
+class Producer : public Thread
+{
+    private:
+        MpmcQueue<unsigned long>& queue;
+        unsigned long count;
+
+    public:
+        Producer(MpmcQueue<unsigned long>& queue, unsigned long count)
+            : Thread(0, 0, JOINABLE, "producer"), queue(queue), count(count) {}
+
+    protected:
+        virtual void job()
+        {
+            for (unsigned long i = 0; i < count; i++)
+            {
+                queue.push(i, UINT_MAX);
+            }
+        }
+};
+
+class Consumer : public Thread
+{
+    private:
+        MpmcQueue<unsigned long>& queue;
+
+    public:
+        unsigned long popped;
+
+        Consumer(MpmcQueue<unsigned long>& queue)
+            : Thread(0, 0, JOINABLE, "consumer"), queue(queue), popped(0) {}
+
+    protected:
+        virtual void job()
+        {
+            unsigned long item;
+            while ( queue.pop(item, UINT_MAX) )
+            {
+                popped++;
+            }
+        }
+};
+
+static double measure(unsigned int producers, unsigned int consumers, unsigned long items)
+{
+    MpmcQueue<unsigned long> queue(1024);
+    Producer* producer[64];
+    Consumer* consumer[64];
+    unsigned long perProducer = items / producers;
+
+    for (unsigned int i = 0; i < producers; i++) producer[i] = new Producer(queue, perProducer);
+    for (unsigned int i = 0; i < consumers; i++) consumer[i] = new Consumer(queue);
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (unsigned int i = 0; i < consumers; i++) consumer[i]->run();
+    for (unsigned int i = 0; i < producers; i++) producer[i]->run();
+    for (unsigned int i = 0; i < producers; i++) producer[i]->join(UINT_MAX);
+    queue.close();
+    unsigned long popped = 0;
+    for (unsigned int i = 0; i < consumers; i++)
+    {
+        consumer[i]->join(UINT_MAX);
+        popped += consumer[i]->popped;
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    for (unsigned int i = 0; i < producers; i++) delete producer[i];
+    for (unsigned int i = 0; i < consumers; i++) delete consumer[i];
+    return popped / elapsed.count() / 1e6;
+}
+
+int main(int argc, char** argv)
+{
+    unsigned int maxThreads = argc > 1 ? (unsigned int)atoi(argv[1]) : (unsigned int)sysconf(_SC_NPROCESSORS_ONLN);
+    unsigned long items = argc > 2 ? strtoul(argv[2], nullptr, 10) : 2000000UL;
+    if ( maxThreads < 1U ) maxThreads = 1U;
+    if ( maxThreads > 64U ) maxThreads = 64U;
+
+    printf("producers consumers   Mitems/s\n");
+    for (unsigned int producers = 1; producers <= maxThreads; producers *= 2)
+    {
+        for (unsigned int consumers = 1; consumers <= maxThreads; consumers *= 2)
+        {
+            printf("%9u %9u %10.2f\n", producers, consumers, measure(producers, consumers, items));
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,172 @@
+// Worst-case wait of a high priority thread for a mutex held by a low priority thread while a medium priority
+// thread hogs the CPU (priority inversion), with Mutex and with InheritingMutex.
+// All three threads run on one CPU with real-time priorities, so it has to run with CAP_SYS_NICE (e.g. as root).
+// Build on Linux: g++ -O2 -std=c++11 -DOSAPI_USE_POSIX -I.. bench_priority_inversion.cpp ../linux/osapi_linux.cpp -pthread
+// Usage: bench_priority_inversion [rounds]
+#include "osapi.h"
+
+#include <cstdio>
+#include <cstdlib>
+
+using namespace osapi;
+
+/** time the low priority thread holds the mutex */
+static const unsigned long long HOLD_NANOS = 1000000ULL;
+/** time the medium priority thread keeps the CPU busy */
+static const unsigned long long SPIN_NANOS = 10000000ULL;
+
+static void spin(unsigned long long nanos)
+{
+    unsigned long long end = monotonicNanos() + nanos;
+    while ( monotonicNanos() < end )
+    {
+    }
+}
+
+template <typename Lock>
+struct Scenario
+{
+    Lock mutex;
+    Signal startLow;
+    Signal lowHolds;
+    Signal startMedium;
+    Signal mediumDone;
+    unsigned long rounds;
+    unsigned long long maxWait;
+    unsigned long long totalWait;
+};
+
+template <typename Lock>
+class Low : public Thread
+{
+    private:
+        Scenario<Lock>& scenario;
+
+    public:
+        Low(Scenario<Lock>& scenario, AffinityMask cpu)
+            : Thread(ThreadAttributes(PRIORITY_ABOVE_NORMAL, 0, JOINABLE, "low", cpu)), scenario(scenario) {}
+
+    protected:
+        virtual void job()
+        {
+            for ( unsigned long i = 0; i < scenario.rounds; i++ )
+            {
+                scenario.startLow.wait(UINT_MAX);
+                scenario.mutex.lock(UINT_MAX);
+                scenario.lowHolds.post();
+                spin(HOLD_NANOS);
+                scenario.mutex.unlock();
+            }
+        }
+};
+
+template <typename Lock>
+class Medium : public Thread
+{
+    private:
+        Scenario<Lock>& scenario;
+
+    public:
+        Medium(Scenario<Lock>& scenario, AffinityMask cpu)
+            : Thread(ThreadAttributes(PRIORITY_HIGH, 0, JOINABLE, "medium", cpu)), scenario(scenario) {}
+
+    protected:
+        virtual void job()
+        {
+            for ( unsigned long i = 0; i < scenario.rounds; i++ )
+            {
+                scenario.startMedium.wait(UINT_MAX);
+                spin(SPIN_NANOS);
+                scenario.mediumDone.post();
+            }
+        }
+};
+
+template <typename Lock>
+class High : public Thread
+{
+    private:
+        Scenario<Lock>& scenario;
+
+    public:
+        High(Scenario<Lock>& scenario, AffinityMask cpu)
+            : Thread(ThreadAttributes(PRIORITY_REALTIME, 0, JOINABLE, "high", cpu)), scenario(scenario) {}
+
+    protected:
+        virtual void job()
+        {
+            for ( unsigned long i = 0; i < scenario.rounds; i++ )
+            {
+                // the low priority thread takes the mutex, then the medium one becomes ready
+                scenario.startLow.post();
+                scenario.lowHolds.wait(UINT_MAX);
+                scenario.startMedium.post();
+
+                unsigned long long start = monotonicNanos();
+                scenario.mutex.lock(UINT_MAX);
+                unsigned long long wait = monotonicNanos() - start;
+                scenario.mutex.unlock();
+
+                if ( wait > scenario.maxWait )
+                {
+                    scenario.maxWait = wait;
+                }
+                scenario.totalWait += wait;
+                scenario.mediumDone.wait(UINT_MAX);
+                // leave the CPU to non real-time threads, keeps clear of the real-time throttling
+                sleep(5);
+            }
+        }
+};
+
+template <typename Lock>
+static bool measure(const char* name, unsigned long rounds, AffinityMask cpu)
+{
+    Scenario<Lock> scenario;
+    scenario.rounds = rounds;
+    scenario.maxWait = 0ULL;
+    scenario.totalWait = 0ULL;
+
+    Low<Lock> low(scenario, cpu);
+    Medium<Lock> medium(scenario, cpu);
+    High<Lock> high(scenario, cpu);
+    if ( !low.run() )
+    {
+        return false;
+    }
+    medium.run();
+    high.run();
+    high.join(UINT_MAX);
+    medium.join(UINT_MAX);
+    low.join(UINT_MAX);
+
+    printf("%-16s rounds %5lu   high priority wait: avg %8.1f us   max %8.1f us\n", name, rounds,
+           scenario.totalWait / 1000.0 / rounds, scenario.maxWait / 1000.0);
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    unsigned long rounds = argc > 1 ? strtoul(argv[1], nullptr, 10) : 50UL;
+    if ( rounds == 0UL )
+    {
+        rounds = 1UL;
+    }
+
+    // one hardware thread, otherwise the low priority thread simply runs on another CPU
+    AffinityMask cores[OSAPI_MAX_CORES];
+    AffinityMask cpu = 1ULL;
+    if ( getPhysicalCores(cores, OSAPI_MAX_CORES) > 0U )
+    {
+        cpu = cores[0] & (~cores[0] + 1ULL);
+    }
+
+    printf("hold %.1f ms, medium priority spin %.1f ms\n", HOLD_NANOS / 1e6, SPIN_NANOS / 1e6);
+    if ( !measure<Mutex>("Mutex", rounds, cpu) )
+    {
+        fprintf(stderr, "can't start real-time threads, run with CAP_SYS_NICE\n");
+        return 1;
+    }
+    measure<InheritingMutex>("InheritingMutex", rounds, cpu);
+    return 0;
+}
@@ -0,0 +1,190 @@
+// One writer publishing a 200-byte snapshot to 1..N readers through SeqLock, SharedMutex and Mutex.
+// Reports the reader throughput, the worst write latency (how long readers hold up the writer) and torn reads.
+// Build on Linux: g++ -O2 -std=c++11 -DOSAPI_USE_POSIX -I.. bench_seq_lock.cpp ../linux/osapi_linux.cpp -pthread
+// Usage: bench_seq_lock [max readers] [writes]
+#include "osapi.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace osapi;
+
+static const unsigned int VALUES = 24;
+
+/** 8 + 24 * 8 = 200 bytes, like a sensor state record */
+struct Snapshot
+{
+    unsigned long long sequence;
+    double values[VALUES];
+};
+
+static void fill(Snapshot& snapshot, unsigned long long sequence)
+{
+    snapshot.sequence = sequence;
+    for (unsigned int i = 0; i < VALUES; i++) snapshot.values[i] = (double)sequence;
+}
+
+static bool consistent(const Snapshot& snapshot)
+{
+    for (unsigned int i = 0; i < VALUES; i++)
+    {
+        if ( snapshot.values[i] != (double)snapshot.sequence ) return false;
+    }
+    return true;
+}
+
+/** Snapshot guarded by a mutex type, read under lock() or lockShared(). */
+template <typename Lock>
+struct Guarded
+{
+    Lock lock;
+    Snapshot snapshot = {};
+};
+
+template <typename Store>
+struct Access;
+
+template <>
+struct Access<Guarded<Mutex> >
+{
+    static void read(Guarded<Mutex>& store, Snapshot& snapshot)
+    {
+        store.lock.lock(UINT_MAX);
+        snapshot = store.snapshot;
+        store.lock.unlock();
+    }
+    static void write(Guarded<Mutex>& store, const Snapshot& snapshot)
+    {
+        store.lock.lock(UINT_MAX);
+        store.snapshot = snapshot;
+        store.lock.unlock();
+    }
+};
+
+template <>
+struct Access<Guarded<SharedMutex> >
+{
+    static void read(Guarded<SharedMutex>& store, Snapshot& snapshot)
+    {
+        store.lock.lockShared(UINT_MAX);
+        snapshot = store.snapshot;
+        store.lock.unlockShared();
+    }
+    static void write(Guarded<SharedMutex>& store, const Snapshot& snapshot)
+    {
+        store.lock.lock(UINT_MAX);
+        store.snapshot = snapshot;
+        store.lock.unlock();
+    }
+};
+
+template <>
+struct Access<SeqLock<Snapshot> >
+{
+    static void read(SeqLock<Snapshot>& store, Snapshot& snapshot) { snapshot = store.read(); }
+    static void write(SeqLock<Snapshot>& store, const Snapshot& snapshot) { store.write(snapshot); }
+};
+
+template <typename Store>
+class Reader : public Thread
+{
+    private:
+        Store& store;
+        std::atomic<bool>& stop;
+
+    public:
+        unsigned long reads;
+        unsigned long torn;
+
+        Reader(Store& store, std::atomic<bool>& stop)
+            : Thread(0, 0, JOINABLE, "reader"), store(store), stop(stop), reads(0), torn(0) {}
+
+    protected:
+        virtual void job()
+        {
+            Snapshot snapshot;
+            while ( !stop.load(std::memory_order_relaxed) )
+            {
+                Access<Store>::read(store, snapshot);
+                if ( !consistent(snapshot) ) torn++;
+                reads++;
+            }
+        }
+};
+
+template <typename Store>
+class Writer : public Thread
+{
+    private:
+        Store& store;
+        unsigned long writes;
+
+    public:
+        unsigned long long maxLatency;
+
+        Writer(Store& store, unsigned long writes)
+            : Thread(0, 0, JOINABLE, "writer"), store(store), writes(writes), maxLatency(0) {}
+
+    protected:
+        virtual void job()
+        {
+            Snapshot snapshot;
+            for (unsigned long i = 1; i <= writes; i++)
+            {
+                fill(snapshot, i);
+                unsigned long long start = monotonicNanos();
+                Access<Store>::write(store, snapshot);
+                unsigned long long latency = monotonicNanos() - start;
+                if ( latency > maxLatency ) maxLatency = latency;
+                // pace the writer, the readers get most of the time in between
+                for (unsigned int spin = 0; spin < 2000U; spin++) cpuRelax();
+            }
+        }
+};
+
+template <typename Store>
+static void measure(const char* name, unsigned int readers, unsigned long writes)
+{
+    Store store;
+    std::atomic<bool> stop(false);
+    Reader<Store>* reader[64];
+    for (unsigned int i = 0; i < readers; i++) reader[i] = new Reader<Store>(store, stop);
+    Writer<Store> writer(store, writes);
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (unsigned int i = 0; i < readers; i++) reader[i]->run();
+    writer.run();
+    writer.join(UINT_MAX);
+    stop = true;
+    for (unsigned int i = 0; i < readers; i++) reader[i]->join(UINT_MAX);
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    unsigned long reads = 0;
+    unsigned long torn = 0;
+    for (unsigned int i = 0; i < readers; i++)
+    {
+        reads += reader[i]->reads;
+        torn += reader[i]->torn;
+        delete reader[i];
+    }
+    printf("%-12s %7u %14.2f %18.1f %6lu\n", name, readers, reads / elapsed.count() / 1e6, writer.maxLatency / 1000.0, torn);
+}
+
+int main(int argc, char** argv)
+{
+    unsigned int maxReaders = argc > 1 ? (unsigned int)atoi(argv[1]) : (unsigned int)sysconf(_SC_NPROCESSORS_ONLN);
+    unsigned long writes = argc > 2 ? strtoul(argv[2], nullptr, 10) : 100000UL;
+    if ( maxReaders < 1U ) maxReaders = 1U;
+    if ( maxReaders > 64U ) maxReaders = 64U;
+
+    printf("snapshot %u bytes, %lu writes\n", (unsigned int)sizeof(Snapshot), writes);
+    printf("lock         readers  reads Mops/s  max write lat us  torn\n");
+    for (unsigned int readers = 1; readers <= maxReaders; readers *= 2)
+    {
+        measure<SeqLock<Snapshot> >("SeqLock", readers, writes);
+        measure<Guarded<SharedMutex> >("SharedMutex", readers, writes);
+        measure<Guarded<Mutex> >("Mutex", readers, writes);
+    }
+    return 0;
+}
@@ -0,0 +1,110 @@
+// SharedMutex versus Mutex guarding a small table, at 90% and 99% reads.
+// Build on Linux: g++ -O2 -std=c++11 -DOSAPI_USE_POSIX -I.. bench_shared_mutex.cpp ../linux/osapi_linux.cpp -pthread
+// Usage: bench_shared_mutex [max threads] [operations per thread]
+#include "osapi.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace osapi;
+
+static const unsigned int TABLE_SIZE = 16;
+
+struct Table
+{
+    unsigned long entries[TABLE_SIZE];
+};
+
+template <typename Lock>
+struct Access;
+
+template <>
+struct Access<Mutex>
+{
+    static void read(Mutex& mutex) { mutex.lock(UINT_MAX); }
+    static void readDone(Mutex& mutex) { mutex.unlock(); }
+};
+
+template <>
+struct Access<SharedMutex>
+{
+    static void read(SharedMutex& mutex) { mutex.lockShared(UINT_MAX); }
+    static void readDone(SharedMutex& mutex) { mutex.unlockShared(); }
+};
+
+template <typename Lock>
+class Worker : public Thread
+{
+    private:
+        Lock& lock;
+        Table& table;
+        unsigned long operations;
+        unsigned int readPercent;
+
+    public:
+        unsigned long checksum;
+
+        Worker(Lock& lock, Table& table, unsigned long operations, unsigned int readPercent)
+            : Thread(0, 0, JOINABLE, "worker"), lock(lock), table(table), operations(operations), readPercent(readPercent), checksum(0) {}
+
+    protected:
+        virtual void job()
+        {
+            unsigned int random = (unsigned int)(uintptr_t)this;
+            for (unsigned long i = 0; i < operations; i++)
+            {
+                random = random * 1103515245U + 12345U;
+                if ( (random >> 16) % 100U < readPercent )
+                {
+                    Access<Lock>::read(lock);
+                    for (unsigned int j = 0; j < TABLE_SIZE; j++) checksum += table.entries[j];
+                    Access<Lock>::readDone(lock);
+                }
+                else
+                {
+                    lock.lock(UINT_MAX);
+                    table.entries[i % TABLE_SIZE]++;
+                    lock.unlock();
+                }
+            }
+        }
+};
+
+template <typename Lock>
+static double measure(unsigned int threads, unsigned long operations, unsigned int readPercent)
+{
+    Lock lock;
+    Table table = {};
+    Worker<Lock>* worker[64];
+    for (unsigned int i = 0; i < threads; i++) worker[i] = new Worker<Lock>(lock, table, operations, readPercent);
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (unsigned int i = 0; i < threads; i++) worker[i]->run();
+    for (unsigned int i = 0; i < threads; i++) worker[i]->join(UINT_MAX);
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    for (unsigned int i = 0; i < threads; i++) delete worker[i];
+    return threads * operations / elapsed.count() / 1e6;
+}
+
+int main(int argc, char** argv)
+{
+    unsigned int maxThreads = argc > 1 ? (unsigned int)atoi(argv[1]) : (unsigned int)sysconf(_SC_NPROCESSORS_ONLN);
+    unsigned long operations = argc > 2 ? strtoul(argv[2], nullptr, 10) : 1000000UL;
+    if ( maxThreads < 1U ) maxThreads = 1U;
+    if ( maxThreads > 64U ) maxThreads = 64U;
+
+    const unsigned int readPercents[] = { 90U, 99U };
+    printf("reads threads  Mutex Mops/s  SharedMutex Mops/s\n");
+    for (unsigned int r = 0; r < 2; r++)
+    {
+        for (unsigned int threads = 1; threads <= maxThreads; threads *= 2)
+        {
+            printf("%4u%% %7u %13.2f %19.2f\n", readPercents[r], threads,
+                   measure<Mutex>(threads, operations, readPercents[r]),
+                   measure<SharedMutex>(threads, operations, readPercents[r]));
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,103 @@
+// Compares virtual (MutexInterface / MortalThread) and compile-time (Mutex / BasicMortalThread) dispatch.
+// Build on Linux: g++ -O2 -std=c++11 -DOSAPI_USE_POSIX -I.. bench_static_dispatch.cpp ../linux/osapi_linux.cpp -pthread
+#include "osapi.h"
+
+#include <chrono>
+#include <cstdio>
+
+using namespace osapi;
+
+static const unsigned long ITERATIONS = 20000000UL;
+
+static double nanosPerOperation(std::chrono::steady_clock::time_point start, unsigned long operations)
+{
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / operations;
+}
+
+static double lockThroughInterface(MutexInterface* volatile* mutex)
+{
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (unsigned long i = 0; i < ITERATIONS; i++)
+    {
+        // reloading the pointer keeps the compiler from devirtualizing the calls
+        (*mutex)->lock(UINT_MAX);
+        (*mutex)->unlock();
+    }
+    return nanosPerOperation(start, ITERATIONS);
+}
+
+static double lockConcrete(Mutex& mutex)
+{
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (unsigned long i = 0; i < ITERATIONS; i++)
+    {
+        mutex.lock(UINT_MAX);
+        mutex.unlock();
+    }
+    return nanosPerOperation(start, ITERATIONS);
+}
+
+class VirtualLoopThread : public MortalThread
+{
+    public:
+        unsigned long counter;
+
+        VirtualLoopThread() : MortalThread(0, 0, "virtual"), counter(0) {}
+
+    protected:
+        virtual void begin() {}
+        virtual void loop()
+        {
+            if ( ++counter == ITERATIONS )
+            {
+                kill();
+            }
+        }
+        virtual void end() {}
+};
+
+class StaticLoopThread : public BasicMortalThread<StaticLoopThread>
+{
+    friend class BasicMortalThread<StaticLoopThread>;
+
+    public:
+        unsigned long counter;
+
+        StaticLoopThread() : BasicMortalThread<StaticLoopThread>(0, 0, "static"), counter(0) {}
+
+    private:
+        void begin() {}
+        void loop()
+        {
+            if ( ++counter == ITERATIONS )
+            {
+                kill();
+            }
+        }
+        void end() {}
+};
+
+template <typename T>
+static double runLoops(T& thread)
+{
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    thread.run();
+    thread.join(UINT_MAX);
+    return nanosPerOperation(start, thread.counter);
+}
+
+int main()
+{
+    Mutex mutex;
+    MutexInterface* volatile polymorphic = &mutex;
+
+    printf("mutex lock/unlock, virtual:    %6.2f ns\n", lockThroughInterface(&polymorphic));
+    printf("mutex lock/unlock, static:     %6.2f ns\n", lockConcrete(mutex));
+
+    VirtualLoopThread virtualThread;
+    StaticLoopThread staticThread;
+    printf("mortal thread loop(), virtual: %6.2f ns\n", runLoops(virtualThread));
+    printf("mortal thread loop(), static:  %6.2f ns\n", runLoops(staticThread));
+    return 0;
+}
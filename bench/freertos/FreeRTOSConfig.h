@@ -0,0 +1,61 @@
+#ifndef FREERTOS_CONFIG_H
+#define FREERTOS_CONFIG_H
+
+/* Configuration for running osapi and its benchmarks on the FreeRTOS POSIX simulator port
+ * (CMake option OSAPI_BACKEND=FREERTOS). Requires FreeRTOS-Kernel V11 or later for
+ * configKERNEL_PROVIDED_STATIC_MEMORY. */
+
+#include <stdlib.h>
+
+#define configUSE_PREEMPTION                    1
+#define configUSE_TIME_SLICING                  1
+#define configUSE_PORT_OPTIMISED_TASK_SELECTION 0
+#define configTICK_RATE_HZ                      1000
+#define configCPU_CLOCK_HZ                      1000000
+#define configMAX_PRIORITIES                    8
+/* in words, the POSIX port runs every task on a pthread and needs at least PTHREAD_STACK_MIN bytes */
+#define configMINIMAL_STACK_SIZE                2048
+#define configSTACK_DEPTH_TYPE                  uint32_t
+#define configMAX_TASK_NAME_LEN                 16
+#define configUSE_16_BIT_TICKS                  0
+#define configIDLE_SHOULD_YIELD                 1
+
+#define configSUPPORT_DYNAMIC_ALLOCATION        1
+#define configSUPPORT_STATIC_ALLOCATION         1
+#define configKERNEL_PROVIDED_STATIC_MEMORY     1
+/* heap_3 uses malloc(), the size is unused */
+#define configTOTAL_HEAP_SIZE                   ( 1024 * 1024 )
+
+#define configUSE_MUTEXES                       1
+#define configUSE_RECURSIVE_MUTEXES             1
+#define configUSE_COUNTING_SEMAPHORES           1
+#define configUSE_TASK_NOTIFICATIONS            1
+#define configUSE_TRACE_FACILITY                1
+#define configGENERATE_RUN_TIME_STATS           0
+#define configQUEUE_REGISTRY_SIZE               0
+
+#define configUSE_IDLE_HOOK                     0
+#define configUSE_TICK_HOOK                     0
+#define configUSE_MALLOC_FAILED_HOOK            0
+#define configCHECK_FOR_STACK_OVERFLOW          0
+
+#define configUSE_TIMERS                        1
+#define configTIMER_TASK_PRIORITY               ( configMAX_PRIORITIES - 1 )
+#define configTIMER_QUEUE_LENGTH                16
+#define configTIMER_TASK_STACK_DEPTH            configMINIMAL_STACK_SIZE
+
+#define INCLUDE_vTaskPrioritySet                1
+#define INCLUDE_uxTaskPriorityGet               1
+#define INCLUDE_vTaskDelete                     1
+#define INCLUDE_vTaskSuspend                    1
+#define INCLUDE_vTaskDelay                      1
+#define INCLUDE_xTaskDelayUntil                 1
+#define INCLUDE_eTaskGetState                   1
+#define INCLUDE_xTaskGetCurrentTaskHandle       1
+#define INCLUDE_xTaskGetSchedulerState          1
+#define INCLUDE_uxTaskGetStackHighWaterMark     1
+#define INCLUDE_xTimerPendFunctionCall          1
+
+#define configASSERT( x )                       if( ( x ) == 0 ) { abort(); }
+
+#endif /* FREERTOS_CONFIG_H */
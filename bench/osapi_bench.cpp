@@ -0,0 +1,320 @@
+// Latency and throughput of the osapi primitives, printed as one JSON document on stdout.
+// Build with the CMake project in the repository root (Linux pthreads, or the FreeRTOS POSIX simulator
+// with -DOSAPI_BACKEND=FREERTOS). Times come from monotonicNanos(), which is tick based on FreeRTOS.
+// Usage: osapi_bench [scale]   (scale multiplies all iteration counts, default 1)
+#include "osapi.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using namespace osapi;
+
+#ifdef OSAPI_USE_FREERTOS
+static const char* const BACKEND = "freertos-posix";
+static const int PRIORITY = tskIDLE_PRIORITY + 1;
+#else
+static const char* const BACKEND = "posix";
+static const int PRIORITY = 0;
+#endif
+
+static const unsigned int STACK_SIZE = 64U * 1024U;
+
+/** Writes the results as the elements of a JSON array. */
+class Report
+{
+    private:
+        bool first;
+
+        void next(const char* name)
+        {
+            printf("%s\n    { \"name\": \"%s\"", first ? "" : ",", name);
+            first = false;
+        }
+
+    public:
+        Report() : first(true) {}
+
+        void begin()
+        {
+            printf("{\n  \"backend\": \"%s\",\n  \"results\": [", BACKEND);
+        }
+
+        void end()
+        {
+            printf("\n  ]\n}\n");
+            fflush(stdout);
+        }
+
+        /** Reports operations spread over a number of threads, as the average time per operation. */
+        void throughput(const char* name, unsigned int threads, unsigned long operations, unsigned long long nanos)
+        {
+            next(name);
+            printf(", \"threads\": %u, \"operations\": %lu, \"ns_per_op\": %.2f }",
+                   threads, operations, (double)nanos / (double)operations);
+        }
+
+        /** Reports the distribution of individually measured samples. */
+        void latency(const char* name, std::vector<unsigned long long>& samples)
+        {
+            std::sort(samples.begin(), samples.end());
+            unsigned long long sum = 0ULL;
+            for ( size_t i = 0; i < samples.size(); i++ )
+            {
+                sum += samples[i];
+            }
+            next(name);
+            printf(", \"samples\": %lu, \"min_ns\": %llu, \"p50_ns\": %llu, \"p99_ns\": %llu, \"max_ns\": %llu, \"mean_ns\": %llu }",
+                   (unsigned long)samples.size(), samples.front(), samples[samples.size() / 2U],
+                   samples[samples.size() * 99U / 100U], samples.back(), sum / samples.size());
+        }
+};
+
+template <typename Lock>
+static void lockUncontended(Report& report, const char* name, unsigned long iterations)
+{
+    Lock mutex;
+    unsigned long long start = monotonicNanos();
+    for ( unsigned long i = 0; i < iterations; i++ )
+    {
+        mutex.lock(UINT_MAX);
+        mutex.unlock();
+    }
+    report.throughput(name, 1U, iterations, monotonicNanos() - start);
+}
+
+static void recursiveNested(Report& report, unsigned long iterations)
+{
+    RecursiveMutex mutex;
+    unsigned long long start = monotonicNanos();
+    for ( unsigned long i = 0; i < iterations; i++ )
+    {
+        mutex.lock(UINT_MAX);
+        mutex.lock(UINT_MAX);
+        mutex.unlock();
+        mutex.unlock();
+    }
+    report.throughput("recursive_mutex_nested", 1U, iterations, monotonicNanos() - start);
+}
+
+template <typename Lock>
+class Contender : public Thread
+{
+    private:
+        Lock& mutex;
+        unsigned long& counter;
+        unsigned long iterations;
+
+    public:
+        Contender(Lock& mutex, unsigned long& counter, unsigned long iterations)
+            : Thread(PRIORITY, STACK_SIZE, JOINABLE, "contender"), mutex(mutex), counter(counter), iterations(iterations) {}
+
+    protected:
+        virtual void job()
+        {
+            for ( unsigned long i = 0; i < iterations; i++ )
+            {
+                mutex.lock(UINT_MAX);
+                counter++;
+                mutex.unlock();
+            }
+        }
+};
+
+template <typename Lock>
+static void lockContended(Report& report, const char* name, unsigned int threads, unsigned long iterations)
+{
+    Lock mutex;
+    unsigned long counter = 0UL;
+    std::vector<Contender<Lock>*> contenders;
+    for ( unsigned int i = 0; i < threads; i++ )
+    {
+        contenders.push_back(new Contender<Lock>(mutex, counter, iterations));
+    }
+    unsigned long long start = monotonicNanos();
+    for ( unsigned int i = 0; i < threads; i++ )
+    {
+        contenders[i]->run();
+    }
+    for ( unsigned int i = 0; i < threads; i++ )
+    {
+        contenders[i]->join(UINT_MAX);
+    }
+    unsigned long long elapsed = monotonicNanos() - start;
+    for ( unsigned int i = 0; i < threads; i++ )
+    {
+        delete contenders[i];
+    }
+    if ( counter != iterations * threads )
+    {
+        fprintf(stderr, "%s: lost updates (%lu of %lu)\n", name, counter, iterations * threads);
+    }
+    report.throughput(name, threads, iterations * threads, elapsed);
+}
+
+class EmptyThread : public Thread
+{
+    public:
+        EmptyThread() : Thread(PRIORITY, STACK_SIZE, JOINABLE, "empty") {}
+
+    protected:
+        virtual void job() {}
+};
+
+static void runJoin(Report& report, unsigned long samples)
+{
+    EmptyThread thread;
+    std::vector<unsigned long long> latencies;
+    for ( unsigned long i = 0; i < samples; i++ )
+    {
+        unsigned long long start = monotonicNanos();
+        thread.run();
+        thread.join(UINT_MAX);
+        latencies.push_back(monotonicNanos() - start);
+    }
+    report.latency("thread_run_join", latencies);
+}
+
+class Ponger : public Thread
+{
+    private:
+        Signal& ping;
+        Signal& pong;
+        unsigned long rounds;
+
+    public:
+        Ponger(Signal& ping, Signal& pong, unsigned long rounds)
+            : Thread(PRIORITY, STACK_SIZE, JOINABLE, "ponger"), ping(ping), pong(pong), rounds(rounds) {}
+
+    protected:
+        virtual void job()
+        {
+            for ( unsigned long i = 0; i < rounds; i++ )
+            {
+                ping.wait(UINT_MAX);
+                pong.post();
+            }
+        }
+};
+
+/** Round trips between the benchmark thread and a second thread; one round trip is two context switches. */
+static void pingPong(Report& report, unsigned long rounds)
+{
+    Signal ping;
+    Signal pong;
+    Ponger ponger(ping, pong, rounds);
+    std::vector<unsigned long long> latencies;
+    ponger.run();
+    for ( unsigned long i = 0; i < rounds; i++ )
+    {
+        unsigned long long start = monotonicNanos();
+        ping.post();
+        pong.wait(UINT_MAX);
+        latencies.push_back(monotonicNanos() - start);
+    }
+    ponger.join(UINT_MAX);
+    report.latency("ping_pong_round_trip", latencies);
+}
+
+class Sleeper : public MortalThread
+{
+    public:
+        Signal ready;
+        unsigned long long exitNanos;
+
+        Sleeper() : MortalThread(PRIORITY, STACK_SIZE, "sleeper"), exitNanos(0ULL) {}
+
+    protected:
+        virtual void begin()
+        {
+            ready.post();
+        }
+
+        virtual void loop()
+        {
+            sleepOrKilled(UINT_MAX);
+        }
+
+        virtual void end()
+        {
+            exitNanos = monotonicNanos();
+        }
+};
+
+/** Time from kill() until end() runs in a MortalThread blocked in sleepOrKilled(). */
+static void killToExit(Report& report, unsigned long samples)
+{
+    Sleeper sleeper;
+    std::vector<unsigned long long> latencies;
+    for ( unsigned long i = 0; i < samples; i++ )
+    {
+        sleeper.run();
+        sleeper.ready.wait(UINT_MAX);
+        unsigned long long start = monotonicNanos();
+        sleeper.kill();
+        sleeper.join(UINT_MAX);
+        latencies.push_back(sleeper.exitNanos - start);
+    }
+    report.latency("mortal_thread_kill_to_exit", latencies);
+}
+
+static void runAll(double scale)
+{
+    unsigned long locks = (unsigned long)(1000000.0 * scale) + 1UL;
+    unsigned long contended = (unsigned long)(100000.0 * scale) + 1UL;
+    unsigned long samples = (unsigned long)(1000.0 * scale) + 1UL;
+    unsigned long rounds = (unsigned long)(10000.0 * scale) + 1UL;
+
+    Report report;
+    report.begin();
+    lockUncontended<Mutex>(report, "mutex_uncontended", locks);
+    lockUncontended<RecursiveMutex>(report, "recursive_mutex_uncontended", locks);
+    recursiveNested(report, locks);
+    lockContended<Mutex>(report, "mutex_contended", 2U, contended);
+    lockContended<Mutex>(report, "mutex_contended", 4U, contended);
+    lockContended<RecursiveMutex>(report, "recursive_mutex_contended", 2U, contended);
+    lockContended<RecursiveMutex>(report, "recursive_mutex_contended", 4U, contended);
+    runJoin(report, samples);
+    pingPong(report, rounds);
+    killToExit(report, samples);
+    report.end();
+}
+
+#ifdef OSAPI_USE_FREERTOS
+/** Runs the benchmarks as a task, since the FreeRTOS primitives need a running scheduler. */
+class Runner : public Thread
+{
+    private:
+        double scale;
+
+    public:
+        Runner(double scale) : Thread(PRIORITY, STACK_SIZE, NOT_JOINABLE, "runner"), scale(scale) {}
+
+    protected:
+        virtual void job()
+        {
+            runAll(scale);
+            exit(0);
+        }
+};
+#endif
+
+int main(int argc, char** argv)
+{
+    double scale = argc > 1 ? atof(argv[1]) : 1.0;
+    if ( scale <= 0.0 )
+    {
+        fprintf(stderr, "usage: %s [scale]\n", argv[0]);
+        return 1;
+    }
+#ifdef OSAPI_USE_FREERTOS
+    static Runner runner(scale);
+    runner.run();
+    vTaskStartScheduler();
+    return 1;
+#else
+    runAll(scale);
+    return 0;
+#endif
+}
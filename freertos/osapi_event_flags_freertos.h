@@ -0,0 +1,48 @@
+#ifndef OSAPI_EVENT_FLAGS_FREERTOS_H
+#define OSAPI_EVENT_FLAGS_FREERTOS_H
+
+#include "osapi.h"
+
+/** Event flags mapped onto a FreeRTOS event group (configUSE_16_BIT_TICKS = 0 gives 24 usable bits). */
+class EventFlags : public EventFlagsInterface
+{
+	private:
+		EventGroupHandle_t xEventGroup;
+
+	public:
+		EventFlags()
+		{
+			xEventGroup = xEventGroupCreate();
+		}
+
+		virtual ~EventFlags()
+		{
+			vEventGroupDelete( xEventGroup );
+		}
+
+		virtual unsigned int set(unsigned int flags) final
+		{
+			return (unsigned int)xEventGroupSetBits( xEventGroup, ( EventBits_t ) flags );
+		}
+
+		virtual unsigned int clear(unsigned int flags) final
+		{
+			return (unsigned int)xEventGroupClearBits( xEventGroup, ( EventBits_t ) flags );
+		}
+
+		virtual unsigned int get() final
+		{
+			return (unsigned int)xEventGroupGetBits( xEventGroup );
+		}
+
+		virtual unsigned int wait(unsigned int flags, EventWait mode, bool clearOnExit, unsigned int timeout) final
+		{
+			EventBits_t bits = xEventGroupWaitBits( xEventGroup, ( EventBits_t ) flags, clearOnExit ? pdTRUE : pdFALSE,
+			                                        ( mode == WAIT_ALL ) ? pdTRUE : pdFALSE, msToTicks( timeout ) );
+			bool satisfied = ( mode == WAIT_ALL ) ? ( bits & flags ) == flags : ( bits & flags ) != 0U;
+			return satisfied ? (unsigned int)bits : 0U;
+		}
+
+};
+
+#endif // OSAPI_EVENT_FLAGS_FREERTOS_H
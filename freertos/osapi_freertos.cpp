@@ -1,10 +1,111 @@
 #include "osapi.h"
 
+#ifdef OSAPI_USE_DWT
+#ifndef OSAPI_DWT_DEVICE_HEADER
+/** CMSIS device header providing DWT, CoreDebug and SystemCoreClock. */
+#define OSAPI_DWT_DEVICE_HEADER CMSIS_device_header
+#endif
+#include OSAPI_DWT_DEVICE_HEADER
+#endif
+
 namespace osapi {
 
 unsigned int getSystemTime() {
     return xTaskGetTickCount();
 }
 
+unsigned int getSystemTimeMs() {
+    return (unsigned int)((unsigned long long)xTaskGetTickCount() * 1000ULL / configTICK_RATE_HZ);
+}
+
+unsigned long long ticksToNanos(unsigned int ticks) {
+    return (unsigned long long)ticks * 1000000000ULL / configTICK_RATE_HZ;
+}
+
+/** Tick count extended to 64 bits with the kernel's own overflow counter, so it never wraps. */
+static unsigned long long tickCount64() {
+    TimeOut_t now;
+    vTaskSetTimeOutState(&now);
+    return ((unsigned long long)(UBaseType_t)now.xOverflowCount << (sizeof(TickType_t) * CHAR_BIT)) + now.xTimeOnEntering;
+}
+
+#ifdef OSAPI_USE_DWT
+/** Difference of two cycle counter readings, including the wraps of the 32-bit counter in between.
+ *  The number of wraps is the one bringing the result closest to the time the tick count says has passed,
+ *  so the result is right however long the counter was not read.
+ *  @param[in] cycles difference of the counter readings, modulo 2^32
+ *  @param[in] ticks number of ticks passed between the readings
+ *  @param[in] cyclesPerTick number of cycles per tick
+ *  @return number of cycles passed between the readings
+ */
+static unsigned long long elapsedCycles(uint32_t cycles, unsigned long long ticks, unsigned long long cyclesPerTick) {
+    unsigned long long estimate = ticks * cyclesPerTick;
+    if ( estimate <= cycles ) {
+        return cycles;
+    }
+    unsigned long long wraps = (estimate - cycles + (1ULL << 31)) >> 32;
+    return (wraps << 32) + cycles;
+}
+#endif
+
+unsigned long long monotonicNanos() {
+#ifdef OSAPI_USE_DWT
+    // the tick count gives the coarse time, the 32-bit cycle counter the resolution
+    static bool started = false;
+    static uint32_t lastCycles = 0U;
+    static unsigned long long lastTicks = 0ULL;
+    static unsigned long long totalCycles = 0ULL;
+    taskENTER_CRITICAL();
+    if ( !started ) {
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+        DWT->CYCCNT = 0U;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+        lastTicks = tickCount64();
+        totalCycles = lastTicks * ( SystemCoreClock / configTICK_RATE_HZ );
+        started = true;
+    }
+    uint32_t cycles = DWT->CYCCNT;
+    unsigned long long ticks = tickCount64();
+    totalCycles += elapsedCycles(cycles - lastCycles, ticks - lastTicks, SystemCoreClock / configTICK_RATE_HZ);
+    lastCycles = cycles;
+    lastTicks = ticks;
+    unsigned long long count = totalCycles;
+    taskEXIT_CRITICAL();
+    const unsigned long long frequency = SystemCoreClock;
+#else
+    unsigned long long count = tickCount64();
+    const unsigned long long frequency = configTICK_RATE_HZ;
+#endif
+    return count / frequency * 1000000000ULL + count % frequency * 1000000000ULL / frequency;
+}
+
+/** Mixes the bits of a task control block address, so blocks allocated at a fixed stride spread evenly. */
+static unsigned int hashAddress(uintptr_t address) {
+    unsigned int hash = (unsigned int)address ^ (unsigned int)((unsigned long long)address >> 32);
+    hash ^= hash >> 16;
+    hash *= 0x7feb352dU;
+    hash ^= hash >> 15;
+    hash *= 0x846ca68bU;
+    hash ^= hash >> 16;
+    return hash;
+}
+
+unsigned int currentThreadIndex() {
+    return hashAddress((uintptr_t)xTaskGetCurrentTaskHandle());
+}
+
+unsigned int getPhysicalCores(AffinityMask* cores, unsigned int max) {
+#ifdef configNUMBER_OF_CORES
+    const unsigned int count = configNUMBER_OF_CORES;
+#else
+    const unsigned int count = 1U;
+#endif
+    unsigned int stored = 0U;
+    for ( ; stored < count && stored < max; stored++ ) {
+        cores[stored] = 1ULL << stored;
+    }
+    return stored;
+}
+
 } // namespace osapi
 
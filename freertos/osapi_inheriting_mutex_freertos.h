@@ -0,0 +1,51 @@
+#ifndef OSAPI_INHERITING_MUTEX_FREERTOS_H
+#define OSAPI_INHERITING_MUTEX_FREERTOS_H
+
+#include "osapi.h"
+
+/** Mutex with priority inheritance for FreeRTOS.
+ *  FreeRTOS mutexes (xSemaphoreCreateMutex) always inherit the priority of the highest waiting task,
+ *  so this is the same primitive as Mutex; the separate type documents the requirement at the call site.
+ */
+class InheritingMutex : public BasicMutex<InheritingMutex>
+{
+		friend class BasicMutex<InheritingMutex>;
+
+	private:
+		SemaphoreHandle_t xSemaphore;
+
+	public:
+		/** Inheriting mutex constructor.
+		 *  @param[in] name optional name, reported by the mutex profiling (OSAPI_MUTEX_PROFILING)
+		 */
+		InheritingMutex(const char* name = nullptr) : BasicMutex<InheritingMutex>(name)
+		{
+			xSemaphore = xSemaphoreCreateMutex();
+		}
+
+		virtual ~InheritingMutex()
+		{
+			if ( xSemaphore != NULL )
+			{
+				vSemaphoreDelete( xSemaphore );
+			}
+		}
+
+	private:
+		bool lockImpl(unsigned int timeout)
+		{
+			if ( xSemaphore != NULL )
+			{
+				return xSemaphoreTake( xSemaphore, msToTicks( timeout ) ) == pdTRUE ? true : false;
+			}
+			return false;
+		}
+
+		void unlockImpl()
+		{
+			xSemaphoreGive( xSemaphore );
+		}
+
+};
+
+#endif // OSAPI_INHERITING_MUTEX_FREERTOS_H
@@ -3,22 +3,28 @@
 
 #include "osapi.h"
 
-class Mutex : public MutexInterface
+class Mutex : public BasicMutex<Mutex>
 {
+		friend class BasicMutex<Mutex>;
+
 	private:
 		SemaphoreHandle_t xSemaphore;
 
 	public:
-		Mutex()
+		/** Mutex constructor.
+		 *  @param[in] name optional name, reported by the mutex profiling (OSAPI_MUTEX_PROFILING)
+		 */
+		Mutex(const char* name = nullptr) : BasicMutex<Mutex>(name)
 		{
 			xSemaphore = xSemaphoreCreateMutex();
 		}
 		
-		virtual bool lock(unsigned int timeout)
+	private:
+		bool lockImpl(unsigned int timeout)
 		{
 			if ( xSemaphore != NULL )
 			{
-				if( xSemaphoreTake( xSemaphore, ( TickType_t ) timeout ) == pdTRUE )
+				if( xSemaphoreTake( xSemaphore, msToTicks( timeout ) ) == pdTRUE )
 				{
 					return true;
 				}
@@ -30,7 +36,7 @@ class Mutex : public MutexInterface
 			return false;
 		}
 		
-		virtual void unlock()
+		void unlockImpl()
 		{
 			xSemaphoreGive( xSemaphore );
 		}
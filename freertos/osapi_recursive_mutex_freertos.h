@@ -3,22 +3,28 @@
 
 #include "osapi.h"
 
-class RecursiveMutex : public MutexInterface
+class RecursiveMutex : public BasicMutex<RecursiveMutex>
 {
+		friend class BasicMutex<RecursiveMutex>;
+
 	private:
 		SemaphoreHandle_t xSemaphore;
 
 	public:
-		RecursiveMutex()
+		/** Recursive mutex constructor.
+		 *  @param[in] name optional name, reported by the mutex profiling (OSAPI_MUTEX_PROFILING)
+		 */
+		RecursiveMutex(const char* name = nullptr) : BasicMutex<RecursiveMutex>(name)
 		{
 			xSemaphore = xSemaphoreCreateRecursiveMutex();
 		}
 
-		virtual bool lock(unsigned int timeout)
+	private:
+		bool lockImpl(unsigned int timeout)
 		{
 			if ( xSemaphore != NULL )
 			{
-				if( xSemaphoreTakeRecursive( xSemaphore, ( TickType_t ) timeout ) == pdTRUE )
+				if( xSemaphoreTakeRecursive( xSemaphore, msToTicks( timeout ) ) == pdTRUE )
 				{
 					return true;
 				}
@@ -30,7 +36,7 @@ class RecursiveMutex : public MutexInterface
 			return false;
 		}
 		
-		virtual void unlock()
+		void unlockImpl()
 		{
 			xSemaphoreGiveRecursive( xSemaphore );
 		}
@@ -0,0 +1,134 @@
+#ifndef OSAPI_SEMAPHORE_FREERTOS_H
+#define OSAPI_SEMAPHORE_FREERTOS_H
+
+#include "osapi.h"
+
+/** Counting semaphore mapped onto a FreeRTOS counting semaphore. */
+class Semaphore
+{
+	private:
+		SemaphoreHandle_t xSemaphore;
+
+	public:
+		/** Semaphore constructor.
+		 *  @param[in] initial initial count
+		 *  @param[in] max maximum count
+		 */
+		Semaphore(unsigned int initial, unsigned int max)
+		{
+			xSemaphore = xSemaphoreCreateCounting( ( UBaseType_t ) max, ( UBaseType_t ) ( initial < max ? initial : max ) );
+		}
+
+		~Semaphore()
+		{
+			if ( xSemaphore != NULL ) vSemaphoreDelete( xSemaphore );
+		}
+
+		/** Decrements the count, if it is not zero.
+		 *  @retval true if the semaphore was acquired
+		 *  @retval false if the count was zero
+		 */
+		bool tryAcquire()
+		{
+			return acquire(0U);
+		}
+
+		/** Decrements the count. While it is zero, blocks the calling thread for the maximum given timeout.
+		 *  @param[in] timeout maximum number of milliseconds to block the calling thread
+		 *  @retval true if the semaphore was acquired
+		 *  @retval false if the semaphore was not acquired within the given time
+		 */
+		bool acquire(unsigned int timeout)
+		{
+			if ( xSemaphore != NULL )
+			{
+				return xSemaphoreTake( xSemaphore, msToTicks( timeout ) ) == pdTRUE ? true : false;
+			}
+			return false;
+		}
+
+		/** Increments the count and wakes up as many blocked threads.
+		 *  @param[in] n number of releases
+		 *  @retval true if the count was incremented n times
+		 *  @retval false if the count reached the maximum before
+		 */
+		bool release(unsigned int n = 1U)
+		{
+			if ( xSemaphore == NULL )
+			{
+				return false;
+			}
+			for ( ; n != 0U; n-- )
+			{
+				if ( xSemaphoreGive( xSemaphore ) != pdTRUE )
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+
+};
+
+/** Binary signal with a single waiting task, built on direct-to-task notifications,
+ *  which are much cheaper than a semaphore object. Uses the notification value of the waiting task.
+ *  post() may be called from any task; posts made while the signal is already set are merged.
+ */
+class Signal
+{
+	private:
+		std::atomic<TaskHandle_t> waiter;
+		std::atomic<unsigned int> posted;
+
+	public:
+		Signal() : waiter(NULL), posted(0U)
+		{
+		}
+
+		/** Sets the signal and wakes up the waiting task. */
+		void post()
+		{
+			posted.store(1U);
+			TaskHandle_t task = waiter.load();
+			if ( task != NULL )
+			{
+				xTaskNotifyGive( task );
+			}
+		}
+
+		/** Waits until the signal is set and clears it. Only one task may wait at a time.
+		 *  @param[in] timeout maximum number of milliseconds to block the calling task
+		 *  @retval true if the signal was set
+		 *  @retval false if the signal was not set within the given time
+		 */
+		bool wait(unsigned int timeout)
+		{
+			if ( posted.exchange(0U) != 0U )
+			{
+				return true;
+			}
+			if ( timeout == 0U )
+			{
+				return false;
+			}
+
+			Deadline left(timeout);
+			bool set;
+			waiter.store(xTaskGetCurrentTaskHandle());
+			// a notification left over from an earlier post() only causes another round
+			while ( !( set = posted.exchange(0U) != 0U ) )
+			{
+				unsigned int remaining = left.remaining();
+				if ( remaining == 0U )
+				{
+					break;
+				}
+				ulTaskNotifyTake( pdTRUE, msToTicks( remaining ) );
+			}
+			waiter.store(NULL);
+			return set;
+		}
+
+};
+
+#endif // OSAPI_SEMAPHORE_FREERTOS_H
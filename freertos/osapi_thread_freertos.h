@@ -4,16 +4,71 @@
 #include "osapi.h"
 // #include <stdio.h>
 
+#ifndef OSAPI_JOIN_NOTIFY_INDEX
+/** Task notification index used to wake up the task waiting in join(). Index 0 stays free for the application
+ *  (and Signal), so the library needs configTASK_NOTIFICATION_ARRAY_ENTRIES > OSAPI_JOIN_NOTIFY_INDEX. */
+#define OSAPI_JOIN_NOTIFY_INDEX 1
+#endif
+
+#if OSAPI_JOIN_NOTIFY_INDEX >= configTASK_NOTIFICATION_ARRAY_ENTRIES
+#error "join() needs its own task notification, raise configTASK_NOTIFICATION_ARRAY_ENTRIES in FreeRTOSConfig.h"
+#endif
+
+#ifndef OSAPI_WAKE_NOTIFY_INDEX
+/** Task notification index used by Thread::sendWakeUp(), e.g. to wake up a MortalThread on kill(). */
+#define OSAPI_WAKE_NOTIFY_INDEX 2
+#endif
+
+#if OSAPI_WAKE_NOTIFY_INDEX >= configTASK_NOTIFICATION_ARRAY_ENTRIES
+#error "sendWakeUp() needs its own task notification, raise configTASK_NOTIFICATION_ARRAY_ENTRIES in FreeRTOSConfig.h"
+#endif
+
+/** Memory for the task control block, provided together with the stack to create a thread without the heap
+ *  (requires configSUPPORT_STATIC_ALLOCATION). */
+typedef StaticTask_t ThreadControlBlock;
+
+#if defined( configNUMBER_OF_CORES ) && ( configNUMBER_OF_CORES > 1 ) && ( configUSE_CORE_AFFINITY == 1 )
+/** FreeRTOS SMP with core affinity, threads are pinned with vTaskCoreAffinitySet(). */
+#define OSAPI_FREERTOS_CORE_AFFINITY 1
+#define OSAPI_FREERTOS_ALL_CORES ( ( 1ULL << configNUMBER_OF_CORES ) - 1ULL )
+#else
+#define OSAPI_FREERTOS_CORE_AFFINITY 0
+#define OSAPI_FREERTOS_ALL_CORES 1ULL
+#endif
+
+/** Maps the portable priority levels to FreeRTOS priorities, see Priority.
+ *  PRIORITY_IDLE is tskIDLE_PRIORITY, PRIORITY_REALTIME is configMAX_PRIORITIES - 1 and the levels in between
+ *  are spread evenly over the priorities left (neighbouring levels share a priority if there are fewer than 7).
+ *  @param[in] priority portable priority level
+ *  @return priority for xTaskCreate()
+ */
+inline int nativePriority(Priority priority)
+{
+  if ( priority == PRIORITY_IDLE || configMAX_PRIORITIES < 2 )
+  {
+    return tskIDLE_PRIORITY;
+  }
+  int level = (int)priority - (int)PRIORITY_LOW;
+  int levels = (int)PRIORITY_REALTIME - (int)PRIORITY_LOW;
+  return tskIDLE_PRIORITY + 1 + level * ( configMAX_PRIORITIES - 2 ) / levels;
+}
+
 /** Thread interface implementation for FreeRTOS. */
-class Thread : public ThreadInterface
+class Thread : public BasicThread<Thread>
 {
+    friend class BasicThread<Thread>;
+
 	private:
     int prioritY;
     unsigned int stackSizE;
     Joinable joinChecK;
     const char* namE;
+    AffinityMask affinitY;
     TaskHandle_t pxCreatedTask;
-    SemaphoreHandle_t xSemaphore;
+    /** JOIN_NONE, JOIN_EXITED or the handle of the task waiting in join() */
+    std::atomic<uintptr_t> joinState;
+    void* stackMemorY;
+    ThreadControlBlock* controlBlocK;
 
   public:
     /** Thread constructor.
@@ -28,30 +83,98 @@ class Thread : public ThreadInterface
       joinChecK = isJoinable;
       namE = name;
       stackSizE = stackSize;
+      affinitY = ANY_CPU;
       pxCreatedTask = NULL;
-      xSemaphore = xSemaphoreCreateBinary();
+      joinState = JOIN_NONE;
+      stackMemorY = NULL;
+      controlBlocK = NULL;
+    }
+
+    /** Thread constructor for statically allocated threads, run() does not use the heap.
+     *  @param[in] priority thread priority
+     *  @param[in] stackSize size of the provided stack in bytes
+     *  @param[in] isJoinable decides if the thread supports join operation or not
+     *  @param[in] stackMemory memory for the thread stack, aligned for StackType_t
+     *  @param[in] controlBlock memory for the task control block
+     *  @param[in] name optional thread name
+     */
+    Thread(int priority, unsigned int stackSize, Joinable isJoinable, void* stackMemory, ThreadControlBlock* controlBlock, const char* name = "unnamed")
+    {
+      prioritY = priority;
+      joinChecK = isJoinable;
+      namE = name;
+      stackSizE = stackSize;
+      affinitY = ANY_CPU;
+      pxCreatedTask = NULL;
+      joinState = JOIN_NONE;
+      stackMemorY = stackMemory;
+      controlBlocK = controlBlock;
+    }
+
+    /** Thread constructor taking a portable priority level, mapped with nativePriority(). */
+    Thread(Priority priority, unsigned int stackSize, Joinable isJoinable, const char* name = "unnamed")
+      : Thread(nativePriority(priority), stackSize, isJoinable, name)
+    {
+    }
+
+    /** Constructor for statically allocated threads taking a portable priority level, mapped with nativePriority(). */
+    Thread(Priority priority, unsigned int stackSize, Joinable isJoinable, void* stackMemory, ThreadControlBlock* controlBlock, const char* name = "unnamed")
+      : Thread(nativePriority(priority), stackSize, isJoinable, stackMemory, controlBlock, name)
+    {
+    }
+
+    /** Thread constructor taking all creation parameters at once.
+     *  @param[in] attributes priority, stack size, joinability, name and affinity of the thread
+     */
+    Thread(const ThreadAttributes& attributes)
+      : Thread(attributes.priority, attributes.stackSize, attributes.joinable, attributes.name)
+    {
+      affinitY = attributes.affinity;
     }
     
     /** Virtual destructor required to properly destroy derived class objects. */
     virtual ~Thread()
     { 
-      vSemaphoreDelete( xSemaphore );
     }
     
+  private:
+
+    static const uintptr_t JOIN_NONE = 0U;
+    static const uintptr_t JOIN_EXITED = 1U;
+
     /** Runs the thread.
     *  @retval true if the thread was started successfully, 
     *  @retval false if the thread was not started successfully, or the thread was already running
     */				
-    virtual bool run() 
+    bool runImpl() 
     {
-      return xTaskCreate(threadFunction, namE, stackSizE, this, prioritY, &pxCreatedTask); == pdPASS ? true : false;
+      // FreeRTOS expects the stack depth in words, not in bytes
+      configSTACK_DEPTH_TYPE depth = (configSTACK_DEPTH_TYPE)( stackSizE / sizeof( StackType_t ) );
+      joinState = JOIN_NONE;
+#if ( OSAPI_FREERTOS_CORE_AFFINITY == 1 )
+      // the affinity is set on creation, so the task never starts on a core outside of it
+      UBaseType_t cores = affinitY == ANY_CPU ? tskNO_AFFINITY : (UBaseType_t)( affinitY & OSAPI_FREERTOS_ALL_CORES );
+      if ( stackMemorY != NULL && controlBlocK != NULL )
+      {
+        pxCreatedTask = xTaskCreateStaticAffinitySet(threadFunction, namE, depth, this, prioritY, (StackType_t*)stackMemorY, controlBlocK, cores);
+        return pxCreatedTask != NULL ? true : false;
+      }
+      return xTaskCreateAffinitySet(threadFunction, namE, depth, this, prioritY, cores, &pxCreatedTask) == pdPASS ? true : false;
+#else
+      if ( stackMemorY != NULL && controlBlocK != NULL )
+      {
+        pxCreatedTask = xTaskCreateStatic(threadFunction, namE, depth, this, prioritY, (StackType_t*)stackMemorY, controlBlocK);
+        return pxCreatedTask != NULL ? true : false;
+      }
+      return xTaskCreate(threadFunction, namE, depth, this, prioritY, &pxCreatedTask) == pdPASS ? true : false;
+#endif
     }
     
     /** Checks if the thread is running.
     *  @retval true if the thread is running
     *  @retval false if the thread is not running
     */
-    virtual bool isRunning()
+    bool isRunningImpl()
     {
       if (pxCreatedTask)
       {	
@@ -69,20 +192,58 @@ class Thread : public ThreadInterface
      *  @retval true if the thread was successfully joined in the given time
      *  @retval false if the thread was not joined within the given time or the thread is not joinable at all
      */
-    virtual bool join(unsigned int timeout)
+    bool joinImpl(unsigned int timeout)
     {
-      if ( joinChecK == JOINABLE )
+      if ( joinChecK != JOINABLE || pxCreatedTask == NULL )
       {
-        return xSemaphoreTake( xSemaphore, pdMS_TO_TICKS( timeout )) == pdTRUE ? true : false;
+        // never started or already joined, there is no task to wait for
+        return false;
       }
-      return false;
+      uintptr_t state = joinState.load();
+      if ( state != JOIN_EXITED && timeout == 0U )
+      {
+        // tryJoin() on a running thread costs a single load
+        return false;
+      }
+      if ( state == JOIN_NONE )
+      {
+        // register for the notification sent by the exiting thread, only one task may join at a time
+        uintptr_t self = (uintptr_t)xTaskGetCurrentTaskHandle();
+        if ( !joinState.compare_exchange_strong( state, self ) && state != JOIN_EXITED )
+        {
+          return false;
+        }
+        Deadline left( timeout );
+        // a notification left over from an earlier join only causes another round
+        while ( ( state = joinState.load() ) != JOIN_EXITED )
+        {
+          unsigned int remaining = left.remaining();
+          if ( remaining == 0U )
+          {
+            if ( joinState.compare_exchange_strong( state, JOIN_NONE ) )
+            {
+              return false;
+            }
+            break;
+          }
+          ulTaskNotifyTakeIndexed( OSAPI_JOIN_NOTIFY_INDEX, pdTRUE, msToTicks( remaining ) );
+        }
+      }
+      else if ( state != JOIN_EXITED )
+      {
+        return false;
+      }
+      joinState = JOIN_NONE;
+      // the task deleted itself, its handle is stale
+      pxCreatedTask = NULL;
+      return true;
     }
 
     /** Checks, if the thread is joinable.
      *  @retval true if the thread is joinable
      *  @retval false if the thread is not joinable
      */
-    virtual bool isJoinable()
+    bool isJoinableImpl()
     {
       if ( joinChecK == JOINABLE )
       {
@@ -95,7 +256,7 @@ class Thread : public ThreadInterface
      *  @retval true if the thread was suspended successfully
      *  @retval false if the thread was not suspended for some reason
      */
-    virtual bool suspend()
+    bool suspendImpl()
     {
       vTaskSuspend( pxCreatedTask );
       eTaskState state = eTaskGetState(pxCreatedTask);
@@ -106,7 +267,7 @@ class Thread : public ThreadInterface
      *  @retval true if the thread was resumed successfully
      *  @retval false if the thread was not resumed for some reason
      */
-    virtual bool resume()
+    bool resumeImpl()
     {
       vTaskResume( pxCreatedTask );
       eTaskState state = eTaskGetState(pxCreatedTask);
@@ -122,7 +283,7 @@ class Thread : public ThreadInterface
      *  @retval true if the priority for the thread was set successfully
      *  @retval false if the priority for the thread was not set successfully for some reason
      */
-    virtual bool setPriority(int priority)
+    bool setPriorityImpl(int priority)
     {
       prioritY = priority;
       vTaskPrioritySet( pxCreatedTask, prioritY );
@@ -136,17 +297,86 @@ class Thread : public ThreadInterface
     /** Gets the thread priority
      *  @return current thread priority
      */
-    virtual int getPriority()
+    int getPriorityImpl()
     {
       return prioritY;
     }
     
+    /** Restricts the thread to a set of cores with vTaskCoreAffinitySet() (FreeRTOS SMP with configUSE_CORE_AFFINITY).
+     *  Without SMP there is only core 0.
+     *  @param[in] affinity mask of the allowed cores, ANY_CPU removes the restriction
+     *  @retval true if the affinity was set successfully (or stored for the next run())
+     *  @retval false if the mask does not contain any core of the system
+     */
+    bool setAffinityImpl(AffinityMask affinity)
+    {
+      if ( ( affinity & OSAPI_FREERTOS_ALL_CORES ) == 0ULL )
+      {
+        return false;
+      }
+#if ( OSAPI_FREERTOS_CORE_AFFINITY == 1 )
+      if ( isRunningImpl() )
+      {
+        vTaskCoreAffinitySet( pxCreatedTask, affinity == ANY_CPU ? tskNO_AFFINITY : (UBaseType_t)( affinity & OSAPI_FREERTOS_ALL_CORES ) );
+      }
+#endif
+      affinitY = affinity;
+      return true;
+    }
+
+    /** Gets the set of cores the thread may run on.
+     *  @return mask of the allowed cores
+     */
+    AffinityMask getAffinityImpl()
+    {
+#if ( OSAPI_FREERTOS_CORE_AFFINITY == 1 )
+      if ( isRunningImpl() )
+      {
+        return (AffinityMask)vTaskCoreAffinityGet( pxCreatedTask ) & OSAPI_FREERTOS_ALL_CORES;
+      }
+#endif
+      return affinitY;
+    }
+
     /** Gets thread name
      *  @return name of the thread
      */
-    virtual const char* getName()
+    const char* getNameImpl()
     {
-      return name_;
+      return namE;
+    }
+
+    /** Reads the counters for the ThreadRegistry with vTaskGetInfo() (requires configUSE_TRACE_FACILITY).
+     *  CPU time is reported when configGENERATE_RUN_TIME_STATS is enabled and OSAPI_RUNTIME_COUNTER_HZ
+     *  gives the frequency of the run time counter. FreeRTOS does not count context switches per task.
+     *  @param[out] statistics receives the counters
+     */
+    void readStatisticsImpl(ThreadStatistics& statistics)
+    {
+      if ( pxCreatedTask == NULL )
+      {
+        return;
+      }
+#if ( configUSE_TRACE_FACILITY == 1 )
+      TaskStatus_t status;
+      vTaskGetInfo( pxCreatedTask, &status, pdTRUE, eInvalid );
+      eTaskState state = status.eCurrentState;
+      statistics.stackFree = (unsigned long)status.usStackHighWaterMark * sizeof( StackType_t );
+#if ( configGENERATE_RUN_TIME_STATS == 1 ) && defined( OSAPI_RUNTIME_COUNTER_HZ )
+      statistics.cpuTime = (unsigned long long)status.ulRunTimeCounter * 1000000000ULL / OSAPI_RUNTIME_COUNTER_HZ;
+#endif
+#else
+      eTaskState state = eTaskGetState( pxCreatedTask );
+#endif
+      switch ( state )
+      {
+        case eRunning: statistics.state = THREAD_RUNNING; break;
+        case eReady: statistics.state = THREAD_READY; break;
+        case eBlocked: statistics.state = THREAD_BLOCKED; break;
+        case eSuspended: statistics.state = THREAD_SUSPENDED; break;
+        case eDeleted: statistics.state = THREAD_TERMINATED; break;
+        default: break;
+      }
     }
   
   protected:
@@ -154,14 +384,17 @@ class Thread : public ThreadInterface
     {
       Thread* osapiThreadObject = reinterpret_cast<Thread*>(argument);
       if (osapiThreadObject) {
-        if ( osapiThreadObject->joinChecK == JOINABLE){
-          xSemaphoreTake( osapiThreadObject->xSemaphore, ( TickType_t ) 0 );
-        }
-
+        osapiThreadObject->enterRegistry();
         osapiThreadObject->job();
+        osapiThreadObject->leaveRegistry();
 
         if ( osapiThreadObject->joinChecK == JOINABLE) {
-          xSemaphoreGive( osapiThreadObject->xSemaphore );
+          // the joining task may destroy the object as soon as it sees JOIN_EXITED, don't touch it afterwards
+          uintptr_t joiner = osapiThreadObject->joinState.exchange( JOIN_EXITED );
+          if ( joiner != JOIN_NONE )
+          {
+            xTaskNotifyGiveIndexed( (TaskHandle_t)joiner, OSAPI_JOIN_NOTIFY_INDEX );
+          }
         }
       }
 
@@ -171,11 +404,49 @@ class Thread : public ThreadInterface
     /** Delays thread execution for a given time.
      *  @param time[in] number of milliseconds to delay thread execution
      */
-    virtual void sleep(unsigned int time)
+    void sleepImpl(unsigned int time)
     {
-      vTaskDelay( (TickType_t)time );
+      vTaskDelay( msToTicks( time ) );
     }
-    
+
+    /** Blocks the thread, called from its own job(), until it is woken up with sendWakeUp() or the deadline passes.
+     *  The wake-up is a task notification on OSAPI_WAKE_NOTIFY_INDEX, which stays pending until it is taken here,
+     *  so the word is not needed to close the race with the waker. The wait ends on the first tick at or after
+     *  the deadline (see ticksUntil()), like vTaskDelayUntil().
+     *  @param[in] word word changed by the waker
+     *  @param[in] expected value the word holds until the thread is to wake up
+     *  @param[in] until deadline of the wait
+     *  @retval true if the thread took the wake-up
+     *  @retval false if the deadline passed
+     */
+    bool waitForWakeUp(std::atomic<unsigned int>& word, unsigned int expected, const Deadline& until)
+    {
+      (void)word;
+      (void)expected;
+      while ( true )
+      {
+        TickType_t ticks = ticksUntil( until );
+        if ( ulTaskNotifyTakeIndexed( OSAPI_WAKE_NOTIFY_INDEX, pdTRUE, ticks ) != 0U )
+        {
+          return true;
+        }
+        if ( ticks == 0U )
+        {
+          return false;
+        }
+      }
+    }
+
+    /** Wakes up the thread blocked in waitForWakeUp(). Only to be called while the thread is known to wait,
+     *  the task may be deleted as soon as it returned from job().
+     *  @param[in] word word the thread waits on, changed by the caller before
+     */
+    void sendWakeUp(std::atomic<unsigned int>& word)
+    {
+      (void)word;
+      xTaskNotifyGiveIndexed( pxCreatedTask, OSAPI_WAKE_NOTIFY_INDEX );
+    }
+
 };
 
 
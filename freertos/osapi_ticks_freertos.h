@@ -0,0 +1,46 @@
+#ifndef OSAPI_TICKS_FREERTOS_H
+#define OSAPI_TICKS_FREERTOS_H
+
+#include "osapi.h"
+
+/** Converts a timeout in milliseconds into FreeRTOS ticks. All timeouts of this library are in milliseconds.
+ *  Rounds up, so a wait never ends before the requested time; UINT_MAX maps to portMAX_DELAY (wait forever).
+ *  @param[in] timeout number of milliseconds
+ *  @return number of ticks
+ */
+inline TickType_t msToTicks(unsigned int timeout)
+{
+	if ( timeout == UINT_MAX )
+	{
+		return portMAX_DELAY;
+	}
+	unsigned long long ticks = ( (unsigned long long)timeout * configTICK_RATE_HZ + 999ULL ) / 1000ULL;
+	return ticks >= (unsigned long long)portMAX_DELAY ? (TickType_t)( portMAX_DELAY - 1U ) : (TickType_t)ticks;
+}
+
+/** Converts a deadline on the monotonicNanos() clock into the number of FreeRTOS ticks to wait for it, so the wait
+ *  ends on the first tick at or after the deadline. monotonicNanos() follows the tick count, so a deadline on a tick
+ *  (e.g. a release time advanced by whole ticks) is met exactly instead of being rounded up to milliseconds.
+ *  @param[in] until deadline
+ *  @return number of ticks, 0 if the deadline passed, portMAX_DELAY if it never expires
+ */
+inline TickType_t ticksUntil(const Deadline& until)
+{
+	if ( until.isNever() )
+	{
+		return portMAX_DELAY;
+	}
+	unsigned long long expiry = until.getExpiry();
+	unsigned long long now = monotonicNanos();
+	if ( now >= expiry )
+	{
+		return 0U;
+	}
+	// first tick at or after the deadline minus the current tick, split into seconds so nothing overflows
+	unsigned long long ticks = ( expiry / 1000000000ULL - now / 1000000000ULL ) * configTICK_RATE_HZ
+		+ ( expiry % 1000000000ULL * configTICK_RATE_HZ + 999999999ULL ) / 1000000000ULL
+		- now % 1000000000ULL * configTICK_RATE_HZ / 1000000000ULL;
+	return ticks >= (unsigned long long)portMAX_DELAY ? (TickType_t)( portMAX_DELAY - 1U ) : (TickType_t)ticks;
+}
+
+#endif // OSAPI_TICKS_FREERTOS_H
@@ -0,0 +1,76 @@
+#ifndef OSAPI_WAIT_QUEUE_FREERTOS_H
+#define OSAPI_WAIT_QUEUE_FREERTOS_H
+
+#include "osapi.h"
+
+#ifndef OSAPI_WAIT_QUEUE_MAX_WAITERS
+/** Maximum number of pending wake-ups kept by a single wait queue. */
+#define OSAPI_WAIT_QUEUE_MAX_WAITERS 32U
+#endif
+
+/** Lets threads block until a 32-bit word changes its value.
+ *  FreeRTOS has no address based waiting, so the waiters sleep on a counting semaphore instead.
+ *  A waker which changed the word gives the semaphore once per registered waiter; a stale token only
+ *  causes a spurious wake-up, which the callers handle by re-checking their condition.
+ */
+class WaitQueue
+{
+	private:
+		SemaphoreHandle_t xSemaphore;
+		std::atomic<unsigned int> waiters;
+
+	public:
+		WaitQueue() : waiters(0U)
+		{
+			xSemaphore = xSemaphoreCreateCounting(OSAPI_WAIT_QUEUE_MAX_WAITERS, 0U);
+		}
+
+		~WaitQueue()
+		{
+			vSemaphoreDelete( xSemaphore );
+		}
+
+		/** Blocks the calling thread as long as the word holds the expected value.
+		 *  May return spuriously, the caller always has to re-check its condition.
+		 *  @param[in] word watched word
+		 *  @param[in] expected value the word is expected to hold
+		 *  @param[in] timeout maximum number of milliseconds to block the calling thread
+		 *  @retval true if the thread was woken up or the word did not hold the expected value
+		 *  @retval false if the timeout expired
+		 */
+		bool wait(std::atomic<unsigned int>& word, unsigned int expected, unsigned int timeout)
+		{
+			bool woken = true;
+			// register first, so a waker that changes the word afterwards is guaranteed to see us
+			waiters.fetch_add(1U);
+			if ( word.load() == expected )
+			{
+				woken = xSemaphoreTake( xSemaphore, msToTicks( timeout ) ) == pdTRUE ? true : false;
+			}
+			waiters.fetch_sub(1U);
+			return woken;
+		}
+
+		/** Wakes up one thread waiting on the word. */
+		void wakeOne(std::atomic<unsigned int>& word)
+		{
+			(void)word;
+			if ( waiters.load() != 0U )
+			{
+				xSemaphoreGive( xSemaphore );
+			}
+		}
+
+		/** Wakes up all threads waiting on the word. */
+		void wakeAll(std::atomic<unsigned int>& word)
+		{
+			(void)word;
+			for ( unsigned int count = waiters.load(); count != 0U; count-- )
+			{
+				xSemaphoreGive( xSemaphore );
+			}
+		}
+
+};
+
+#endif // OSAPI_WAIT_QUEUE_FREERTOS_H
@@ -0,0 +1,95 @@
+#ifndef OSAPI_EVENT_FLAGS_LINUX_H
+#define OSAPI_EVENT_FLAGS_LINUX_H
+
+#include "osapi.h"
+
+/** Event flags kept in a single futex word. Setting flags without waiters costs one atomic operation. */
+class EventFlags : public EventFlagsInterface
+{
+	private:
+		std::atomic<unsigned int> flagS;
+		std::atomic<unsigned int> waiters;
+
+		static bool satisfied(unsigned int current, unsigned int flags, EventWait mode)
+		{
+			return ( mode == WAIT_ALL ) ? ( current & flags ) == flags : ( current & flags ) != 0U;
+		}
+
+	public:
+		EventFlags() : flagS(0U), waiters(0U)
+		{
+		}
+
+		virtual unsigned int set(unsigned int flags) final
+		{
+			unsigned int current = flagS.fetch_or(flags) | flags;
+			if ( waiters.load() != 0U )
+			{
+				// every waiter has its own condition, let all of them re-check
+				futexWake(flagS, INT_MAX);
+			}
+			return current;
+		}
+
+		virtual unsigned int clear(unsigned int flags) final
+		{
+			return flagS.fetch_and(~flags);
+		}
+
+		virtual unsigned int get() final
+		{
+			return flagS.load();
+		}
+
+		virtual unsigned int wait(unsigned int flags, EventWait mode, bool clearOnExit, unsigned int timeout) final
+		{
+			struct timespec deadline;
+			const struct timespec* until = nullptr;
+			bool registered = false;
+			unsigned int current = flagS.load();
+			while ( true )
+			{
+				if ( satisfied(current, flags, mode) )
+				{
+					if ( clearOnExit && !flagS.compare_exchange_weak(current, current & ~flags) )
+					{
+						continue;
+					}
+					break;
+				}
+				if ( timeout == 0U )
+				{
+					current = 0U;
+					break;
+				}
+				if ( !registered )
+				{
+					// register before the word is compared by the kernel, so set() can't miss us
+					registered = true;
+					waiters.fetch_add(1U);
+					until = futexDeadline(timeout, deadline);
+					current = flagS.load();
+					continue;
+				}
+				if ( !futexWait(flagS, current, until) )
+				{
+					current = flagS.load();
+					if ( !satisfied(current, flags, mode) )
+					{
+						current = 0U;
+						break;
+					}
+					continue;
+				}
+				current = flagS.load();
+			}
+			if ( registered )
+			{
+				waiters.fetch_sub(1U);
+			}
+			return current;
+		}
+
+};
+
+#endif // OSAPI_EVENT_FLAGS_LINUX_H
@@ -0,0 +1,71 @@
+#ifndef OSAPI_FUTEX_LINUX_H
+#define OSAPI_FUTEX_LINUX_H
+
+#include "osapi.h"
+
+/** Converts a relative timeout into an absolute CLOCK_MONOTONIC deadline, as expected by futexWait().
+ *  @param[in] timeout number of milliseconds from now, UINT_MAX means waiting forever (like INFINITE or osWaitForever)
+ *  @param[out] deadline storage for the computed deadline
+ *  @return pointer to the deadline, or nullptr if the timeout is infinite
+ */
+inline const struct timespec* futexDeadline(unsigned int timeout, struct timespec& deadline)
+{
+	if (timeout == UINT_MAX)
+	{
+		return nullptr;
+	}
+	clock_gettime(CLOCK_MONOTONIC, &deadline);
+	deadline.tv_sec += timeout / 1000U;
+	deadline.tv_nsec += (long)(timeout % 1000U) * 1000000L;
+	if (deadline.tv_nsec >= 1000000000L)
+	{
+		deadline.tv_sec++;
+		deadline.tv_nsec -= 1000000000L;
+	}
+	return &deadline;
+}
+
+/** Converts a deadline on the monotonicNanos() clock, which is CLOCK_MONOTONIC, into the timespec expected by futexWait().
+ *  Keeps the full resolution, so an absolute wait ends on the deadline itself rather than on the next millisecond.
+ *  @param[in] until deadline
+ *  @param[out] deadline storage for the converted deadline
+ *  @return pointer to the deadline, or nullptr if it never expires
+ */
+inline const struct timespec* futexDeadline(const Deadline& until, struct timespec& deadline)
+{
+	if (until.isNever())
+	{
+		return nullptr;
+	}
+	deadline.tv_sec = (time_t)(until.getExpiry() / 1000000000ULL);
+	deadline.tv_nsec = (long)(until.getExpiry() % 1000000000ULL);
+	return &deadline;
+}
+
+/** Blocks the calling thread as long as the word holds the expected value.
+ *  Returns on wake-up, on a spurious wake-up, if the word did not hold the expected value or when the deadline passes,
+ *  so the caller always has to re-check its condition.
+ *  @param[in] word futex word (must be a 32-bit value)
+ *  @param[in] expected value the word is expected to hold
+ *  @param[in] deadline absolute CLOCK_MONOTONIC deadline, nullptr to wait forever
+ *  @retval true if the thread was woken up or the word did not hold the expected value
+ *  @retval false if the deadline passed
+ */
+inline bool futexWait(std::atomic<unsigned int>& word, unsigned int expected, const struct timespec* deadline)
+{
+	static_assert(sizeof(std::atomic<unsigned int>) == sizeof(int), "futex word has to be a plain 32-bit integer");
+	long result = syscall(SYS_futex, reinterpret_cast<unsigned int*>(&word), FUTEX_WAIT_BITSET | FUTEX_PRIVATE_FLAG,
+	                      expected, deadline, nullptr, FUTEX_BITSET_MATCH_ANY);
+	return ( result == -1 && errno == ETIMEDOUT ) ? false : true;
+}
+
+/** Wakes up threads blocked in futexWait() on the given word.
+ *  @param[in] word futex word
+ *  @param[in] count maximum number of threads to wake up, INT_MAX wakes up all of them
+ */
+inline void futexWake(std::atomic<unsigned int>& word, int count)
+{
+	syscall(SYS_futex, reinterpret_cast<unsigned int*>(&word), FUTEX_WAKE | FUTEX_PRIVATE_FLAG, count, nullptr, nullptr, 0);
+}
+
+#endif // OSAPI_FUTEX_LINUX_H
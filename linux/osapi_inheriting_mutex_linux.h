@@ -0,0 +1,67 @@
+#ifndef OSAPI_INHERITING_MUTEX_LINUX_H
+#define OSAPI_INHERITING_MUTEX_LINUX_H
+
+#include "osapi.h"
+
+/** Mutex with priority inheritance for Linux, a PTHREAD_PRIO_INHERIT pthread mutex (PI futex).
+ *  While a higher priority thread waits, the owner runs with the priority of that thread,
+ *  so medium priority threads can't preempt it and delay the waiter without bound (priority inversion).
+ *  The inherited priority only matters for real-time policies, see Priority.
+ */
+class InheritingMutex : public BasicMutex<InheritingMutex>
+{
+		friend class BasicMutex<InheritingMutex>;
+
+	private:
+		pthread_mutex_t mutex;
+
+	public:
+		/** Inheriting mutex constructor.
+		 *  @param[in] name optional name, reported by the mutex profiling (OSAPI_MUTEX_PROFILING)
+		 */
+		InheritingMutex(const char* name = nullptr) : BasicMutex<InheritingMutex>(name)
+		{
+			pthread_mutexattr_t attr;
+			pthread_mutexattr_init(&attr);
+			pthread_mutexattr_setprotocol(&attr, PTHREAD_PRIO_INHERIT);
+			pthread_mutex_init(&mutex, &attr);
+			pthread_mutexattr_destroy(&attr);
+		}
+
+		virtual ~InheritingMutex()
+		{
+			pthread_mutex_destroy(&mutex);
+		}
+
+	private:
+		bool lockImpl(unsigned int timeout)
+		{
+			if ( timeout == 0U )
+			{
+				return pthread_mutex_trylock(&mutex) == 0 ? true : false;
+			}
+			if ( timeout == UINT_MAX )
+			{
+				return pthread_mutex_lock(&mutex) == 0 ? true : false;
+			}
+			// pthread_mutex_timedlock() measures its deadline against CLOCK_REALTIME
+			struct timespec deadline;
+			clock_gettime(CLOCK_REALTIME, &deadline);
+			deadline.tv_sec += timeout / 1000U;
+			deadline.tv_nsec += (long)(timeout % 1000U) * 1000000L;
+			if ( deadline.tv_nsec >= 1000000000L )
+			{
+				deadline.tv_sec++;
+				deadline.tv_nsec -= 1000000000L;
+			}
+			return pthread_mutex_timedlock(&mutex, &deadline) == 0 ? true : false;
+		}
+
+		void unlockImpl()
+		{
+			pthread_mutex_unlock(&mutex);
+		}
+
+};
+
+#endif // OSAPI_INHERITING_MUTEX_LINUX_H
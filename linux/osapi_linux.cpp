@@ -0,0 +1,120 @@
+#include "osapi.h"
+
+namespace osapi {
+
+unsigned int getSystemTime() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (unsigned int)(now.tv_sec * 1000ULL + now.tv_nsec / 1000000L);
+}
+
+unsigned int getSystemTimeMs() {
+    return getSystemTime();
+}
+
+unsigned long long ticksToNanos(unsigned int ticks) {
+    return (unsigned long long)ticks * 1000000ULL;
+}
+
+unsigned long long monotonicNanos() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (unsigned long long)now.tv_sec * 1000000000ULL + (unsigned long long)now.tv_nsec;
+}
+
+unsigned int currentThreadIndex() {
+    static std::atomic<unsigned int> next(0U);
+    thread_local unsigned int index = next.fetch_add(1U, std::memory_order_relaxed);
+    return index;
+}
+
+/** Parses a CPU list like "0-3,8" from /sys/devices/system/cpu into a mask. */
+static AffinityMask readCpuList(const char* path) {
+    AffinityMask mask = 0ULL;
+    FILE* file = fopen(path, "r");
+    if ( file == nullptr ) {
+        return mask;
+    }
+    unsigned int first;
+    unsigned int last;
+    int separator;
+    while ( fscanf(file, "%u", &first) == 1 ) {
+        last = first;
+        separator = fgetc(file);
+        if ( separator == '-' ) {
+            if ( fscanf(file, "%u", &last) != 1 ) {
+                break;
+            }
+            separator = fgetc(file);
+        }
+        for ( unsigned int cpu = first; cpu <= last && cpu < sizeof(AffinityMask) * CHAR_BIT; cpu++ ) {
+            mask |= 1ULL << cpu;
+        }
+        if ( separator != ',' ) {
+            break;
+        }
+    }
+    fclose(file);
+    return mask;
+}
+
+unsigned int getPhysicalCores(AffinityMask* cores, unsigned int max) {
+    const unsigned int cpus = sizeof(AffinityMask) * CHAR_BIT;
+    AffinityMask online = readCpuList("/sys/devices/system/cpu/online");
+    if ( online == 0ULL ) {
+        // no sysfs, assume CPUs 0..n-1 without hardware threads
+        long count = sysconf(_SC_NPROCESSORS_ONLN);
+        online = count >= (long)cpus ? ~0ULL : (1ULL << (count > 0 ? count : 1)) - 1ULL;
+    }
+    AffinityMask coreMasks[cpus];
+    int packages[cpus];
+    unsigned int found = 0U;
+    AffinityMask seen = 0ULL;
+    char path[96];
+    for ( unsigned int cpu = 0U; cpu < cpus; cpu++ ) {
+        AffinityMask bit = 1ULL << cpu;
+        if ( (online & bit) == 0ULL || (seen & bit) != 0ULL ) {
+            continue;
+        }
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%u/topology/thread_siblings_list", cpu);
+        AffinityMask siblings = readCpuList(path) & online;
+        if ( siblings == 0ULL ) {
+            siblings = bit;
+        }
+        int package = 0;
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%u/topology/physical_package_id", cpu);
+        FILE* file = fopen(path, "r");
+        if ( file != nullptr ) {
+            if ( fscanf(file, "%d", &package) != 1 ) {
+                package = 0;
+            }
+            fclose(file);
+        }
+        coreMasks[found] = siblings;
+        packages[found] = package;
+        found++;
+        seen |= siblings;
+    }
+
+    // interleave the packages: the first core of every package, then the second one of every package, ...
+    unsigned int rank[cpus];
+    for ( unsigned int i = 0U; i < found; i++ ) {
+        rank[i] = 0U;
+        for ( unsigned int j = 0U; j < i; j++ ) {
+            if ( packages[j] == packages[i] ) {
+                rank[i]++;
+            }
+        }
+    }
+    unsigned int stored = 0U;
+    for ( unsigned int round = 0U; stored < found && stored < max; round++ ) {
+        for ( unsigned int i = 0U; i < found && stored < max; i++ ) {
+            if ( rank[i] == round ) {
+                cores[stored++] = coreMasks[i];
+            }
+        }
+    }
+    return stored;
+}
+
+} // namespace osapi
@@ -0,0 +1,62 @@
+#ifndef OSAPI_MUTEX_LINUX_H
+#define OSAPI_MUTEX_LINUX_H
+
+#include "osapi.h"
+
+/** Mutex implementation for Linux.
+ *  The uncontended case is a single compare-and-swap in user space, the kernel is entered
+ *  (futex wait/wake) only when the mutex is contended.
+ */
+class Mutex : public BasicMutex<Mutex>
+{
+		friend class BasicMutex<Mutex>;
+
+	private:
+		/** 0 - unlocked, 1 - locked, 2 - locked and other threads may be waiting */
+		std::atomic<unsigned int> state;
+
+	public:
+		/** Mutex constructor.
+		 *  @param[in] name optional name, reported by the mutex profiling (OSAPI_MUTEX_PROFILING)
+		 */
+		Mutex(const char* name = nullptr) : BasicMutex<Mutex>(name), state(0U)
+		{
+		}
+
+	private:
+		bool lockImpl(unsigned int timeout)
+		{
+			unsigned int expected = 0U;
+			if ( state.compare_exchange_strong(expected, 1U, std::memory_order_acquire, std::memory_order_relaxed) )
+			{
+				return true;
+			}
+			if ( timeout == 0U )
+			{
+				return false;
+			}
+
+			struct timespec deadline;
+			const struct timespec* until = futexDeadline(timeout, deadline);
+			// mark the mutex as contended, so that the owner wakes us up on unlock
+			while ( state.exchange(2U, std::memory_order_acquire) != 0U )
+			{
+				if ( !futexWait(state, 2U, until) )
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+
+		void unlockImpl()
+		{
+			if ( state.exchange(0U, std::memory_order_release) == 2U )
+			{
+				futexWake(state, 1);
+			}
+		}
+
+};
+
+#endif // OSAPI_MUTEX_LINUX_H
@@ -0,0 +1,57 @@
+#ifndef OSAPI_RECURSIVE_MUTEX_LINUX_H
+#define OSAPI_RECURSIVE_MUTEX_LINUX_H
+
+#include "osapi.h"
+
+/** Recursive mutex implementation for Linux, built on top of the futex based InternalLock. */
+class RecursiveMutex : public BasicMutex<RecursiveMutex>
+{
+		friend class BasicMutex<RecursiveMutex>;
+
+	private:
+		InternalLock mutex;
+		std::atomic<pthread_t> owner;
+		unsigned int count;
+
+	public:
+		/** Recursive mutex constructor.
+		 *  @param[in] name optional name, reported by the mutex profiling (OSAPI_MUTEX_PROFILING)
+		 */
+		RecursiveMutex(const char* name = nullptr) : BasicMutex<RecursiveMutex>(name), owner(0), count(0U)
+		{
+		}
+
+	private:
+		bool lockImpl(unsigned int timeout)
+		{
+			pthread_t self = pthread_self();
+			// only the owning thread could have stored its own id here
+			if ( pthread_equal(owner.load(std::memory_order_relaxed), self) )
+			{
+				count++;
+				return true;
+			}
+			if ( mutex.lock(timeout) )
+			{
+				owner.store(self, std::memory_order_relaxed);
+				count = 1U;
+				return true;
+			}
+			return false;
+		}
+
+		void unlockImpl()
+		{
+			if ( pthread_equal(owner.load(std::memory_order_relaxed), pthread_self()) )
+			{
+				if ( --count == 0U )
+				{
+					owner.store(0, std::memory_order_relaxed);
+					mutex.unlock();
+				}
+			}
+		}
+
+};
+
+#endif // OSAPI_RECURSIVE_MUTEX_LINUX_H
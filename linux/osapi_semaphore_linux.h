@@ -0,0 +1,158 @@
+#ifndef OSAPI_SEMAPHORE_LINUX_H
+#define OSAPI_SEMAPHORE_LINUX_H
+
+#include "osapi.h"
+
+/** Counting semaphore kept in a user-space counter. The futex is only touched when a thread has to block,
+ *  or when a release finds blocked threads.
+ */
+class Semaphore
+{
+	private:
+		std::atomic<unsigned int> count;
+		unsigned int maX;
+		std::atomic<unsigned int> waiters;
+
+	public:
+		/** Semaphore constructor.
+		 *  @param[in] initial initial count
+		 *  @param[in] max maximum count
+		 */
+		Semaphore(unsigned int initial, unsigned int max) : count(initial < max ? initial : max), maX(max), waiters(0U)
+		{
+		}
+
+		/** Decrements the count, if it is not zero.
+		 *  @retval true if the semaphore was acquired
+		 *  @retval false if the count was zero
+		 */
+		bool tryAcquire()
+		{
+			unsigned int current = count.load(std::memory_order_relaxed);
+			while ( current != 0U )
+			{
+				if ( count.compare_exchange_weak(current, current - 1U, std::memory_order_acquire, std::memory_order_relaxed) )
+				{
+					return true;
+				}
+			}
+			return false;
+		}
+
+		/** Decrements the count. While it is zero, blocks the calling thread for the maximum given timeout.
+		 *  @param[in] timeout maximum number of milliseconds to block the calling thread
+		 *  @retval true if the semaphore was acquired
+		 *  @retval false if the semaphore was not acquired within the given time
+		 */
+		bool acquire(unsigned int timeout)
+		{
+			if ( tryAcquire() )
+			{
+				return true;
+			}
+			if ( timeout == 0U )
+			{
+				return false;
+			}
+
+			struct timespec deadline;
+			const struct timespec* until = futexDeadline(timeout, deadline);
+			bool acquired;
+			// register before the last check, so release() can't miss us
+			waiters.fetch_add(1U);
+			while ( !( acquired = tryAcquire() ) )
+			{
+				if ( !futexWait(count, 0U, until) )
+				{
+					acquired = tryAcquire();
+					break;
+				}
+			}
+			waiters.fetch_sub(1U);
+			return acquired;
+		}
+
+		/** Increments the count and wakes up as many blocked threads.
+		 *  @param[in] n number of releases
+		 *  @retval true if the count was incremented
+		 *  @retval false if the count would exceed the maximum, the count is left unchanged
+		 */
+		bool release(unsigned int n = 1U)
+		{
+			unsigned int current = count.load(std::memory_order_relaxed);
+			do
+			{
+				if ( n > maX - current )
+				{
+					return false;
+				}
+			}
+			while ( !count.compare_exchange_weak(current, current + n) );
+			if ( waiters.load() != 0U )
+			{
+				futexWake(count, n < (unsigned int)INT_MAX ? (int)n : INT_MAX);
+			}
+			return true;
+		}
+
+};
+
+/** Binary signal with a single waiting thread, the cheapest way to wake up one particular thread.
+ *  post() may be called from any thread; posts made while the signal is already set are merged.
+ */
+class Signal
+{
+	private:
+		std::atomic<unsigned int> posted;
+		std::atomic<bool> waiting;
+
+	public:
+		Signal() : posted(0U), waiting(false)
+		{
+		}
+
+		/** Sets the signal and wakes up the waiting thread. */
+		void post()
+		{
+			posted.store(1U);
+			if ( waiting.load() )
+			{
+				futexWake(posted, 1);
+			}
+		}
+
+		/** Waits until the signal is set and clears it. Only one thread may wait at a time.
+		 *  @param[in] timeout maximum number of milliseconds to block the calling thread
+		 *  @retval true if the signal was set
+		 *  @retval false if the signal was not set within the given time
+		 */
+		bool wait(unsigned int timeout)
+		{
+			if ( posted.exchange(0U) != 0U )
+			{
+				return true;
+			}
+			if ( timeout == 0U )
+			{
+				return false;
+			}
+
+			struct timespec deadline;
+			const struct timespec* until = futexDeadline(timeout, deadline);
+			bool set;
+			waiting.store(true);
+			while ( !( set = posted.exchange(0U) != 0U ) )
+			{
+				if ( !futexWait(posted, 0U, until) )
+				{
+					set = posted.exchange(0U) != 0U;
+					break;
+				}
+			}
+			waiting.store(false);
+			return set;
+		}
+
+};
+
+#endif // OSAPI_SEMAPHORE_LINUX_H
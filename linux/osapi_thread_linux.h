@@ -0,0 +1,550 @@
+#ifndef OSAPI_THREAD_LINUX_H
+#define OSAPI_THREAD_LINUX_H
+
+#include "osapi.h"
+
+/** Placeholder for the thread control block memory, glibc keeps its thread descriptor inside the provided stack. */
+struct ThreadControlBlock
+{
+};
+
+#ifndef OSAPI_STATIC_THREAD_MIN_STACK
+/** Smallest stack accepted by StaticThread at compile time: PTHREAD_STACK_MIN of glibc on x86-64 and 32-bit ARM.
+ *  Targets with a larger PTHREAD_STACK_MIN (aarch64: 128 KiB) reject smaller stacks in run().
+ */
+#define OSAPI_STATIC_THREAD_MIN_STACK 16384U
+#endif
+
+#ifndef OSAPI_REALTIME_POLICY
+/** Scheduling policy of threads with a positive priority, SCHED_FIFO or SCHED_RR (round-robin between equal priorities). */
+#define OSAPI_REALTIME_POLICY SCHED_FIFO
+#endif
+
+/** Maps the portable priority levels, see Priority.
+ *  @param[in] priority portable priority level
+ *  @return -1 (SCHED_IDLE), 0 (SCHED_OTHER) or a real-time priority of OSAPI_REALTIME_POLICY
+ */
+inline int nativePriority(Priority priority)
+{
+    int lowest = sched_get_priority_min(OSAPI_REALTIME_POLICY);
+    int highest = sched_get_priority_max(OSAPI_REALTIME_POLICY);
+    switch ( priority )
+    {
+        case PRIORITY_IDLE: return -1;
+        case PRIORITY_ABOVE_NORMAL: return lowest;
+        case PRIORITY_HIGH: return (lowest + highest) / 2;
+        case PRIORITY_REALTIME: return highest - 1;
+        default: return 0;
+    }
+}
+
+/** Thread interface implementation for Linux (POSIX threads). */
+class Thread : public BasicThread<Thread>
+{
+        friend class BasicThread<Thread>;
+
+    private:
+        int prioritY;
+        unsigned int stackSizE;
+        Joinable joinablE;
+        const char* namE;
+        AffinityMask affinitY;
+        pthread_t threadHandle;
+        std::atomic<bool> running;
+        /** kernel thread id while job() runs, 0 otherwise */
+        std::atomic<pid_t> tiD;
+        /** futex word for join(): JOIN_RUNNING, JOIN_WAITING or JOIN_EXITED */
+        std::atomic<unsigned int> joinState;
+        bool started;
+        void* stackMemorY;
+
+    public:
+        /** Thread constructor.
+         *  @param[in] priority thread priority: negative runs the thread with SCHED_IDLE, 0 with SCHED_OTHER and 1 to 99
+         *                      with the real-time policy OSAPI_REALTIME_POLICY (run() fails without CAP_SYS_NICE then)
+         *  @param[in] stackSize thread stack size in bytes, 0 selects the system default
+         *  @param[in] isJoinable decides if the thread supports join operation or not
+         *  @param[in] name optional thread name
+         */
+        Thread(int priority, unsigned int stackSize, Joinable isJoinable, const char* name = "unnamed")
+        {
+            prioritY = priority;
+            stackSizE = stackSize;
+            joinablE = isJoinable;
+            namE = name;
+            affinitY = ANY_CPU;
+            running = false;
+            tiD = 0;
+            joinState = JOIN_RUNNING;
+            started = false;
+            stackMemorY = nullptr;
+        }
+
+        /** Thread constructor for statically allocated threads, run() does not use the heap.
+         *  The provided stack is not reused before the previous run was joined.
+         *  @param[in] priority thread priority
+         *  @param[in] stackSize size of the provided stack in bytes, at least PTHREAD_STACK_MIN (run() fails otherwise)
+         *  @param[in] isJoinable decides if the thread supports join operation or not
+         *  @param[in] stackMemory memory for the thread stack, 16-byte aligned
+         *  @param[in] controlBlock memory for the thread control block (unused, the thread descriptor lives in the stack)
+         *  @param[in] name optional thread name
+         */
+        Thread(int priority, unsigned int stackSize, Joinable isJoinable, void* stackMemory, ThreadControlBlock* controlBlock, const char* name = "unnamed")
+            : Thread(priority, stackSize, isJoinable, name)
+        {
+            (void)controlBlock;
+            stackMemorY = stackMemory;
+        }
+
+        /** Thread constructor taking a portable priority level, mapped with nativePriority(). */
+        Thread(Priority priority, unsigned int stackSize, Joinable isJoinable, const char* name = "unnamed")
+            : Thread(nativePriority(priority), stackSize, isJoinable, name)
+        {
+        }
+
+        /** Constructor for statically allocated threads taking a portable priority level, mapped with nativePriority(). */
+        Thread(Priority priority, unsigned int stackSize, Joinable isJoinable, void* stackMemory, ThreadControlBlock* controlBlock, const char* name = "unnamed")
+            : Thread(nativePriority(priority), stackSize, isJoinable, stackMemory, controlBlock, name)
+        {
+        }
+
+        /** Thread constructor taking all creation parameters at once.
+         *  @param[in] attributes priority, stack size, joinability, name and affinity of the thread
+         */
+        Thread(const ThreadAttributes& attributes)
+            : Thread(attributes.priority, attributes.stackSize, attributes.joinable, attributes.name)
+        {
+            affinitY = attributes.affinity;
+        }
+
+        /** Virtual destructor required to properly destroy derived class objects. */
+        virtual ~Thread()
+        {
+            if ( started && joinablE == JOINABLE )
+            {
+                pthread_detach(threadHandle);
+            }
+        }
+
+    private:
+
+        static const unsigned int JOIN_RUNNING = 0U;
+        static const unsigned int JOIN_WAITING = 1U;
+        static const unsigned int JOIN_EXITED = 2U;
+
+        /** Runs the thread.
+         *  @retval true if the thread was started successfully,
+         *  @retval false if the thread was not started successfully, or the thread was already running
+         */
+        bool runImpl()
+        {
+            if ( running )
+            {
+                return false;
+            }
+            if ( started && joinablE == JOINABLE )
+            {
+                // previous run was never joined, release its resources
+                pthread_detach(threadHandle);
+            }
+            started = false;
+
+            pthread_attr_t attr;
+            pthread_attr_init(&attr);
+            if ( stackMemorY != nullptr && pthread_attr_setstack(&attr, stackMemorY, stackSizE) != 0 )
+            {
+                // stack smaller than PTHREAD_STACK_MIN
+                pthread_attr_destroy(&attr);
+                return false;
+            }
+            else if ( stackSizE != 0U )
+            {
+                pthread_attr_setstacksize(&attr, stackSizE < PTHREAD_STACK_MIN ? PTHREAD_STACK_MIN : stackSizE);
+            }
+            pthread_attr_setdetachstate(&attr, joinablE == JOINABLE ? PTHREAD_CREATE_JOINABLE : PTHREAD_CREATE_DETACHED);
+            struct sched_param param;
+            pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+            pthread_attr_setschedpolicy(&attr, schedulingPolicy(prioritY, param));
+            pthread_attr_setschedparam(&attr, &param);
+            cpu_set_t cpus;
+            if ( affinitY != ANY_CPU &&
+                 ( !allowedCpus(affinitY, cpus) || pthread_attr_setaffinity_np(&attr, sizeof(cpus), &cpus) != 0 ) )
+            {
+                // no CPU of the mask is available to the process
+                pthread_attr_destroy(&attr);
+                return false;
+            }
+
+            running = true;
+            joinState = JOIN_RUNNING;
+            if ( pthread_create(&threadHandle, &attr, threadFunction, this) != 0 )
+            {
+                running = false;
+                pthread_attr_destroy(&attr);
+                return false;
+            }
+            pthread_attr_destroy(&attr);
+            started = true;
+            return true;
+        }
+
+        /** Checks if the thread is running.
+         *  @retval true if the thread is running
+         *  @retval false if the thread is not running
+         */
+        bool isRunningImpl()
+        {
+            return running;
+        }
+
+        /** Waits for the thread to finish executing, with a given timeout.
+         *  @param timeout[in] number of milliseconds to wait for the thread to finish executing
+         *  @retval true if the thread was successfully joined in the given time
+         *  @retval false if the thread was not joined within the given time or the thread is not joinable at all
+         */
+        bool joinImpl(unsigned int timeout)
+        {
+            if ( joinablE != JOINABLE || !started )
+            {
+                return false;
+            }
+
+            unsigned int state = joinState.load();
+            if ( state != JOIN_EXITED )
+            {
+                if ( timeout == 0U )
+                {
+                    // tryJoin() on a running thread costs a single load
+                    return false;
+                }
+                struct timespec deadline;
+                const struct timespec* until = futexDeadline(timeout, deadline);
+                while ( state != JOIN_EXITED )
+                {
+                    // announce the waiter, so the exiting thread only makes the wake-up system call when needed
+                    if ( state == JOIN_RUNNING && !joinState.compare_exchange_weak(state, JOIN_WAITING) )
+                    {
+                        continue;
+                    }
+                    if ( !futexWait(joinState, JOIN_WAITING, until) )
+                    {
+                        return false;
+                    }
+                    state = joinState.load();
+                }
+            }
+
+            // the thread is about to return from threadFunction(), reaping it does not block for long
+            if ( pthread_join(threadHandle, nullptr) == 0 )
+            {
+                started = false;
+                return true;
+            }
+            return false;
+        }
+
+        /** Checks, if the thread is joinable.
+         *  @retval true if the thread is joinable
+         *  @retval false if the thread is not joinable
+         */
+        bool isJoinableImpl()
+        {
+            return joinablE == JOINABLE ? true : false;
+        }
+
+        /** Suspends thread execution.
+         *  POSIX threads cannot be suspended by another thread, so this call always fails.
+         *  @retval false always
+         */
+        bool suspendImpl()
+        {
+            return false;
+        }
+
+        /** Resumes thread execution.
+         *  POSIX threads cannot be suspended by another thread, so this call always fails.
+         *  @retval false always
+         */
+        bool resumeImpl()
+        {
+            return false;
+        }
+
+        /** Sets thread priority
+         *  @param[in] priority new thread priority, see the constructor
+         *  @retval true if the priority for the thread was set successfully
+         *  @retval false if the priority for the thread was not set successfully for some reason
+         */
+        bool setPriorityImpl(int priority)
+        {
+            prioritY = priority;
+            if ( running )
+            {
+                struct sched_param param;
+                int policy = schedulingPolicy(prioritY, param);
+                return pthread_setschedparam(threadHandle, policy, &param) == 0 ? true : false;
+            }
+            return true;
+        }
+
+        /** Gets the scheduling policy and parameters for a priority, see the constructor.
+         *  @param[in] priority thread priority
+         *  @param[out] param receives the scheduling priority within the policy
+         *  @return scheduling policy
+         */
+        static int schedulingPolicy(int priority, struct sched_param& param)
+        {
+            param.sched_priority = priority > 0 ? priority : 0;
+            if ( priority < 0 )
+            {
+                return SCHED_IDLE;
+            }
+            return priority == 0 ? SCHED_OTHER : OSAPI_REALTIME_POLICY;
+        }
+
+        /** Gets the thread priority
+         *  @return current thread priority
+         */
+        int getPriorityImpl()
+        {
+            return prioritY;
+        }
+
+        /** Restricts the thread to a set of CPUs with pthread_setaffinity_np().
+         *  @param[in] affinity mask of the allowed logical CPUs, ANY_CPU removes the restriction
+         *  @retval true if the affinity was set successfully (or stored for the next run())
+         *  @retval false if the mask does not contain any CPU available to the process
+         */
+        bool setAffinityImpl(AffinityMask affinity)
+        {
+            cpu_set_t cpus;
+            if ( !allowedCpus(affinity, cpus) )
+            {
+                return false;
+            }
+            if ( running && pthread_setaffinity_np(threadHandle, sizeof(cpus), &cpus) != 0 )
+            {
+                return false;
+            }
+            affinitY = affinity;
+            return true;
+        }
+
+        /** Gets the set of CPUs the thread may run on.
+         *  @return mask of the allowed logical CPUs, the stored mask if the thread does not run
+         */
+        AffinityMask getAffinityImpl()
+        {
+            cpu_set_t cpus;
+            if ( running && pthread_getaffinity_np(threadHandle, sizeof(cpus), &cpus) == 0 )
+            {
+                AffinityMask affinity = 0ULL;
+                for ( unsigned int cpu = 0U; cpu < sizeof(AffinityMask) * CHAR_BIT; cpu++ )
+                {
+                    if ( CPU_ISSET(cpu, &cpus) )
+                    {
+                        affinity |= 1ULL << cpu;
+                    }
+                }
+                return affinity;
+            }
+            return affinitY;
+        }
+
+        /** Intersects an affinity mask with the CPUs available to the process.
+         *  @param[in] affinity mask of the logical CPUs, ANY_CPU for all of them
+         *  @param[out] cpus receives the CPUs the thread may run on
+         *  @retval true if the set contains at least one CPU
+         *  @retval false if the mask does not contain any CPU available to the process
+         */
+        static bool allowedCpus(AffinityMask affinity, cpu_set_t& cpus)
+        {
+            cpu_set_t allowed;
+            sched_getaffinity(0, sizeof(allowed), &allowed);
+            if ( toCpuSet(affinity, cpus) )
+            {
+                CPU_AND(&cpus, &cpus, &allowed);
+            }
+            else
+            {
+                // ANY_CPU: every CPU the process may use
+                cpus = allowed;
+            }
+            return CPU_COUNT(&cpus) != 0;
+        }
+
+        /** Converts an affinity mask into a cpu_set_t.
+         *  @retval true if the mask restricts the thread
+         *  @retval false for ANY_CPU
+         */
+        static bool toCpuSet(AffinityMask affinity, cpu_set_t& cpus)
+        {
+            if ( affinity == ANY_CPU )
+            {
+                return false;
+            }
+            CPU_ZERO(&cpus);
+            for ( unsigned int cpu = 0U; cpu < sizeof(AffinityMask) * CHAR_BIT; cpu++ )
+            {
+                if ( (affinity >> cpu) & 1ULL )
+                {
+                    CPU_SET(cpu, &cpus);
+                }
+            }
+            return true;
+        }
+
+        /** Gets thread name
+         *  @return name of the thread
+         */
+        const char* getNameImpl()
+        {
+            return namE;
+        }
+
+        /** Reads the counters for the ThreadRegistry: CPU time from the thread CPU clock and the tid,
+         *  by which finishStatisticsImpl() reads the rest.
+         *  @param[out] statistics receives the counters
+         */
+        void readStatisticsImpl(ThreadStatistics& statistics)
+        {
+            pid_t tid = tiD.load();
+            if ( tid == 0 )
+            {
+                statistics.state = THREAD_TERMINATED;
+                return;
+            }
+            statistics.nativeId = (unsigned long)tid;
+
+            clockid_t clock;
+            struct timespec cpu;
+            if ( pthread_getcpuclockid(threadHandle, &clock) == 0 && clock_gettime(clock, &cpu) == 0 )
+            {
+                statistics.cpuTime = cpu.tv_sec * 1000000000ULL + cpu.tv_nsec;
+            }
+        }
+
+        /** Reads state and context switches from /proc/self/task/<tid>/status, with the registry unlocked.
+         *  If the thread exited in the meantime the file is gone and the counters are left as they are
+         *  (in the rare case its tid was reused already, they describe the new thread).
+         *  @param[in,out] statistics counters read by readStatisticsImpl()
+         */
+        static void finishStatisticsImpl(ThreadStatistics& statistics)
+        {
+            if ( statistics.nativeId == 0UL )
+            {
+                return;
+            }
+            char path[48];
+            snprintf(path, sizeof(path), "/proc/self/task/%lu/status", statistics.nativeId);
+            FILE* file = fopen(path, "r");
+            if ( file == nullptr )
+            {
+                return;
+            }
+            char line[128];
+            char state;
+            while ( fgets(line, sizeof(line), file) != nullptr )
+            {
+                if ( sscanf(line, "State: %c", &state) == 1 )
+                {
+                    switch ( state )
+                    {
+                        case 'R': statistics.state = THREAD_RUNNING; break;
+                        case 'S':
+                        case 'D': statistics.state = THREAD_BLOCKED; break;
+                        case 'T':
+                        case 't': statistics.state = THREAD_SUSPENDED; break;
+                        case 'Z':
+                        case 'X': statistics.state = THREAD_TERMINATED; break;
+                        default: break;
+                    }
+                }
+                sscanf(line, "voluntary_ctxt_switches: %lu", &statistics.voluntarySwitches);
+                sscanf(line, "nonvoluntary_ctxt_switches: %lu", &statistics.involuntarySwitches);
+            }
+            fclose(file);
+        }
+
+    protected:
+        static void* threadFunction(void* argument)
+        {
+            Thread* osapiThreadObject = reinterpret_cast<Thread*>(argument);
+            if (osapiThreadObject)
+            {
+                // Linux limits thread names to 15 characters
+                char shortName[16];
+                strncpy(shortName, osapiThreadObject->namE, sizeof(shortName) - 1U);
+                shortName[sizeof(shortName) - 1U] = '\0';
+                pthread_setname_np(pthread_self(), shortName);
+                osapiThreadObject->tiD = (pid_t)syscall(SYS_gettid);
+
+                osapiThreadObject->enterRegistry();
+                osapiThreadObject->job();
+
+                osapiThreadObject->leaveRegistry();
+                osapiThreadObject->tiD = 0;
+                if ( osapiThreadObject->joinablE == JOINABLE &&
+                     osapiThreadObject->joinState.exchange(JOIN_EXITED) == JOIN_WAITING )
+                {
+                    // a waiting join() can't return before isRunning() reports false, the object is still alive
+                    futexWake(osapiThreadObject->joinState, INT_MAX);
+                }
+                // last access to the object, the owner may destroy it as soon as isRunning() reports false
+                osapiThreadObject->running = false;
+            }
+            return nullptr;
+        }
+
+        /** Delays thread execution for a given time.
+         *  @param time[in] number of milliseconds to delay thread execution
+         */
+        void sleepImpl(unsigned int time)
+        {
+            struct timespec deadline;
+            if ( futexDeadline(time, deadline) == nullptr )
+            {
+                while ( true )
+                {
+                    pause();
+                }
+            }
+            while ( clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, nullptr) == EINTR )
+            {
+            }
+        }
+
+        /** Blocks the thread, called from its own job(), while the word holds the expected value, until it is woken up
+         *  with sendWakeUp() or the deadline passes. The waker changes the word before it calls sendWakeUp().
+         *  The futex waits on the absolute deadline, which is not rounded to milliseconds.
+         *  @param[in] word word changed by the waker
+         *  @param[in] expected value the word holds until the thread is to wake up
+         *  @param[in] until deadline of the wait
+         *  @retval true if the thread was woken up
+         *  @retval false if the deadline passed
+         */
+        bool waitForWakeUp(std::atomic<unsigned int>& word, unsigned int expected, const Deadline& until)
+        {
+            struct timespec deadline;
+            const struct timespec* at = futexDeadline(until, deadline);
+            while ( word.load() == expected )
+            {
+                if ( !futexWait(word, expected, at) )
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        /** Wakes up the thread blocked in waitForWakeUp() on the word.
+         *  @param[in] word word the thread waits on, changed by the caller before
+         */
+        void sendWakeUp(std::atomic<unsigned int>& word)
+        {
+            futexWake(word, 1);
+        }
+
+};
+
+#endif // OSAPI_THREAD_LINUX_H
@@ -0,0 +1,38 @@
+#ifndef OSAPI_WAIT_QUEUE_LINUX_H
+#define OSAPI_WAIT_QUEUE_LINUX_H
+
+#include "osapi.h"
+
+/** Lets threads block until a 32-bit word changes its value. Direct mapping onto the Linux futex. */
+class WaitQueue
+{
+	public:
+		/** Blocks the calling thread as long as the word holds the expected value.
+		 *  May return spuriously, the caller always has to re-check its condition.
+		 *  @param[in] word watched word
+		 *  @param[in] expected value the word is expected to hold
+		 *  @param[in] timeout maximum number of milliseconds to block the calling thread
+		 *  @retval true if the thread was woken up or the word did not hold the expected value
+		 *  @retval false if the timeout expired
+		 */
+		bool wait(std::atomic<unsigned int>& word, unsigned int expected, unsigned int timeout)
+		{
+			struct timespec deadline;
+			return futexWait(word, expected, futexDeadline(timeout, deadline));
+		}
+
+		/** Wakes up one thread waiting on the word. */
+		void wakeOne(std::atomic<unsigned int>& word)
+		{
+			futexWake(word, 1);
+		}
+
+		/** Wakes up all threads waiting on the word. */
+		void wakeAll(std::atomic<unsigned int>& word)
+		{
+			futexWake(word, INT_MAX);
+		}
+
+};
+
+#endif // OSAPI_WAIT_QUEUE_LINUX_H
@@ -1,11 +1,21 @@
 #ifndef OSAPI_H
 #define OSAPI_H
 
-#include <csignal>
+#include <atomic>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
 
 // check if any operating system was selected
-#if (!defined _WIN32) && (!defined OSAPI_USE_FREERTOS) && (!defined OSAPI_USE_RTX)
-#error "Unable to select operating system for OSAPI. Provide a compiler definition: OSAPI_USE_FREERTOS or OSAPI_USE_RTX"
+#if (!defined _WIN32) && (!defined OSAPI_USE_FREERTOS) && (!defined OSAPI_USE_RTX) && (!defined OSAPI_USE_POSIX)
+#error "Unable to select operating system for OSAPI. Provide a compiler definition: OSAPI_USE_FREERTOS, OSAPI_USE_RTX or OSAPI_USE_POSIX"
 #endif
 
 
@@ -17,48 +27,183 @@
 #include "FreeRTOS.h"
 #include "task.h"
 #include "semphr.h"
+#include "event_groups.h"
 #endif
 
 #ifdef OSAPI_USE_RTX
 #include "cmsis_os2.h"
+#include "rtx_os.h"
 #endif
 
+#ifdef OSAPI_USE_POSIX
+#include <cerrno>
+#include <ctime>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#endif
 
 namespace osapi {
 
+/**
+ * This system-related function returns the number of system ticks
+ * elapsed since the system was started.
+ *
+ * @return current value of the system tick counter
+ */
+unsigned int getSystemTime();
+
+/**
+ * This system-related function returns the number of milliseconds
+ * elapsed since the system was started, independently of the tick rate.
+ *
+ * @return current value of the system time in milliseconds
+ */
+unsigned int getSystemTimeMs();
+
+/**
+ * This system-related function converts a number of system ticks (see getSystemTime())
+ * into nanoseconds, e.g. to schedule a period given in ticks on the monotonicNanos() clock.
+ *
+ * @param[in] ticks number of system ticks
+ * @return duration in nanoseconds
+ */
+unsigned long long ticksToNanos(unsigned int ticks);
+
+/**
+ * This system-related function returns the number of nanoseconds
+ * elapsed since an arbitrary point in the past, as a 64-bit value that does not wrap.
+ * Backed by clock_gettime(CLOCK_MONOTONIC) on Linux, QueryPerformanceCounter on Windows,
+ * and on FreeRTOS/RTX by the tick counter, refined by the DWT cycle counter with OSAPI_USE_DWT defined
+ * (the tick counter tells how often the 32-bit cycle counter wrapped in between two calls).
+ * Not to be called from interrupt handlers on FreeRTOS/RTX.
+ *
+ * @return current value of the monotonic clock in nanoseconds
+ */
+unsigned long long monotonicNanos();
+
+/**
+ * This system-related function returns a small number identifying the calling thread, used to spread
+ * threads over per-thread slots (e.g. the reader counters of SharedMutex). On Linux and Windows the numbers
+ * are handed out round robin on a thread's first call; FreeRTOS and RTX have no portable thread-local storage,
+ * there it is a hash of the task control block address. Different threads may get the same number.
+ *
+ * @return index of the calling thread
+ */
+unsigned int currentThreadIndex();
+
+/** Set of CPU cores, bit n selects core n (logical CPU n on Linux and Windows). */
+typedef unsigned long long AffinityMask;
+
+/** Affinity mask allowing a thread to run on every core. */
+const AffinityMask ANY_CPU = ~0ULL;
+
+/**
+ * This system-related function lists the physical cores of the system, each as the mask
+ * of its logical CPUs (hardware threads). Cores of different packages are interleaved,
+ * so taking the first n entries spreads n threads over the packages as well.
+ * Read from /sys/devices/system/cpu on Linux, GetLogicalProcessorInformation() on Windows,
+ * configNUMBER_OF_CORES on FreeRTOS; RTX reports a single core.
+ *
+ * @param[out] cores array receiving one mask per physical core
+ * @param[in] max size of the array
+ * @return number of cores stored in the array
+ */
+unsigned int getPhysicalCores(AffinityMask* cores, unsigned int max);
+
+#include "osapi_deadline.h"
 #include "osapi_mutex_interface.h"
 #include "osapi_thread_interface.h"
+#include "osapi_event_flags_interface.h"
+#include "osapi_mutex_profile.h"
+#include "osapi_thread_statistics.h"
+#include "osapi_basic_mutex.h"
+#include "osapi_basic_thread.h"
+#include "osapi_cpu.h"
+#include "osapi_affinity.h"
+#include "osapi_static_instance.h"
+
+// blocking primitives of the selected system, the portable callOnce() builds on them
+#ifdef _WIN32
+#include "windows/osapi_wait_queue_windows.h"
+#endif
+
+#ifdef OSAPI_USE_FREERTOS
+#include "freertos/osapi_ticks_freertos.h"
+#include "freertos/osapi_wait_queue_freertos.h"
+#endif
+
+#ifdef OSAPI_USE_RTX
+#include "rtx/osapi_ticks_rtx.h"
+#include "rtx/osapi_wait_queue_rtx.h"
+#endif
+
+#ifdef OSAPI_USE_POSIX
+#include "linux/osapi_futex_linux.h"
+#include "linux/osapi_wait_queue_linux.h"
+#endif
+
+#include "osapi_once.h"
+#include "osapi_registry.h"
 
 #ifdef _WIN32
 // include windows implementation
 #include "windows/osapi_mutex_windows.h"
 #include "windows/osapi_recursive_mutex_windows.h"
+#include "windows/osapi_inheriting_mutex_windows.h"
 #include "windows/osapi_thread_windows.h"
+#include "windows/osapi_event_flags_windows.h"
+#include "windows/osapi_semaphore_windows.h"
 #endif
 
 #ifdef OSAPI_USE_FREERTOS
 // include FreeRTOS implementation
 #include "freertos/osapi_mutex_freertos.h"
 #include "freertos/osapi_recursive_mutex_freertos.h"
+#include "freertos/osapi_inheriting_mutex_freertos.h"
 #include "freertos/osapi_thread_freertos.h"
+#include "freertos/osapi_event_flags_freertos.h"
+#include "freertos/osapi_semaphore_freertos.h"
 #endif
 
 #ifdef OSAPI_USE_RTX
 // include RTX implementation
 #include "rtx/osapi_mutex_rtx.h"
 #include "rtx/osapi_recursive_mutex_rtx.h"
+#include "rtx/osapi_inheriting_mutex_rtx.h"
 #include "rtx/osapi_thread_rtx.h"
+#include "rtx/osapi_event_flags_rtx.h"
+#include "rtx/osapi_semaphore_rtx.h"
 #endif
 
-#include "osapi_mortal_thread.h"
+#ifdef OSAPI_USE_POSIX
+// include Linux (pthread) implementation
+#include "linux/osapi_mutex_linux.h"
+#include "linux/osapi_recursive_mutex_linux.h"
+#include "linux/osapi_inheriting_mutex_linux.h"
+#include "linux/osapi_thread_linux.h"
+#include "linux/osapi_event_flags_linux.h"
+#include "linux/osapi_semaphore_linux.h"
+#endif
 
-/**
- * This system-related function returns the number of system ticks
- * elapsed since the system was started.
- *
- * @return current value of the system tick counter
- */
-unsigned int getSystemTime();
+#include "osapi_mutex_registry.h"
+#include "osapi_thread_registry.h"
+#include "osapi_published.h"
+#include "osapi_static_thread.h"
+#include "osapi_mortal_thread.h"
+#include "osapi_periodic_thread.h"
+#include "osapi_adaptive_mutex.h"
+#include "osapi_shared_mutex.h"
+#include "osapi_lock.h"
+#include "osapi_condition_variable.h"
+#include "osapi_spsc_queue.h"
+#include "osapi_mpmc_queue.h"
+#include "osapi_seq_lock.h"
+#include "osapi_thread_pool.h"
+#include "osapi_timer_service.h"
+#include "osapi_memory_pool.h"
 
 } // namespace osapi
 
@@ -0,0 +1,137 @@
+#ifndef OSAPI_ADAPTIVE_MUTEX_H
+#define OSAPI_ADAPTIVE_MUTEX_H
+
+#ifndef OSAPI_ADAPTIVE_MUTEX_MAX_SPIN
+/** Default upper bound for the number of spin iterations before the calling thread is parked. */
+#define OSAPI_ADAPTIVE_MUTEX_MAX_SPIN 1000U
+#endif
+
+#ifndef OSAPI_ADAPTIVE_MUTEX_MIN_SPIN
+/** Number of spin iterations always tried, regardless of the learned budget. */
+#define OSAPI_ADAPTIVE_MUTEX_MIN_SPIN 10U
+#endif
+
+/** Mutex which spins for a while before it parks the calling thread.
+ *  Useful for very short critical sections on multi-core systems, where a thread that blocks right away
+ *  is descheduled for much longer than the lock is held. The spin budget follows the number of spins
+ *  that were recently needed to get the lock, and shrinks when spinning does not pay off.
+ *  The spinning phase is bounded by the budget, counted in spin iterations (cpuRelax() calls), and the time
+ *  spent spinning is taken from the timeout, so lock() never blocks longer than asked for.
+ *  On single-core systems spinning can't succeed, construct the mutex with maxSpin = 0 there.
+ */
+class AdaptiveMutex : public BasicMutex<AdaptiveMutex>
+{
+    friend class BasicMutex<AdaptiveMutex>;
+
+private:
+    InternalLock mutex;
+    std::atomic<bool> locked;
+    std::atomic<unsigned int> averageSpins;
+    unsigned int maxSpin;
+    std::atomic<unsigned long> spinAcquisitions;
+    std::atomic<unsigned long> parkedAcquisitions;
+
+    unsigned int spinBudget()
+    {
+        unsigned int budget = 2U * averageSpins.load(std::memory_order_relaxed) + OSAPI_ADAPTIVE_MUTEX_MIN_SPIN;
+        return budget < maxSpin ? budget : maxSpin;
+    }
+
+public:
+    /** Adaptive mutex constructor.
+     *  @param[in] maxSpin upper bound for the number of spin iterations before the calling thread is parked
+     *  @param[in] name optional name, reported by the mutex profiling (OSAPI_MUTEX_PROFILING)
+     */
+    AdaptiveMutex(unsigned int maxSpin = OSAPI_ADAPTIVE_MUTEX_MAX_SPIN, const char* name = nullptr)
+        : BasicMutex<AdaptiveMutex>(name), locked(false), averageSpins(0U), maxSpin(maxSpin), spinAcquisitions(0UL), parkedAcquisitions(0UL)
+    {
+    }
+
+    /** Gets the number of contended acquisitions that were won by spinning.
+     *  @return number of acquisitions won by spinning
+     */
+    unsigned long getSpinAcquisitions()
+    {
+        return spinAcquisitions.load(std::memory_order_relaxed);
+    }
+
+    /** Gets the number of contended acquisitions that had to park (block) the calling thread.
+     *  @return number of acquisitions that parked the calling thread
+     */
+    unsigned long getParkedAcquisitions()
+    {
+        return parkedAcquisitions.load(std::memory_order_relaxed);
+    }
+
+    /** Gets the current spin budget.
+     *  @return maximum number of spin iterations tried before the calling thread is parked
+     */
+    unsigned int getSpinBudget()
+    {
+        return spinBudget();
+    }
+
+    /** Resets acquisition counters. */
+    void resetStatistics()
+    {
+        spinAcquisitions.store(0UL, std::memory_order_relaxed);
+        parkedAcquisitions.store(0UL, std::memory_order_relaxed);
+    }
+
+private:
+
+    /** Locks the mutex. If it is already locked, the calling thread spins for a bounded number of iterations
+     *  and then blocks, waiting for the mutex to become unlocked, for the maximum given timeout.
+     *  @param[in] timeout maximum number of milliseconds allowed to block the calling thread while waiting for mutex to become unlocked
+     *  @retval true if the mutex was successfully locked (calling thread owns now this lock)
+     *  @retval false if the mutex was not locked within the given time
+     */
+    bool lockImpl(unsigned int timeout)
+    {
+        if ( mutex.lock(0U) )
+        {
+            locked.store(true, std::memory_order_relaxed);
+            return true;
+        }
+        if ( timeout == 0U )
+        {
+            return false;
+        }
+
+        Deadline left(timeout);
+        unsigned int average = averageSpins.load(std::memory_order_relaxed);
+        unsigned int budget = spinBudget();
+        for ( unsigned int spins = 1U; spins <= budget; spins++ )
+        {
+            cpuRelax();
+            // only touch the mutex when it looks free, so spinning threads don't bounce its cache line
+            if ( !locked.load(std::memory_order_relaxed) && mutex.lock(0U) )
+            {
+                locked.store(true, std::memory_order_relaxed);
+                averageSpins.store(average + ((int)spins - (int)average) / 8, std::memory_order_relaxed);
+                spinAcquisitions.fetch_add(1UL, std::memory_order_relaxed);
+                return true;
+            }
+        }
+
+        // spinning did not pay off, lower the budget for the next time
+        averageSpins.store(average - average / 8U, std::memory_order_relaxed);
+        if ( mutex.lock(left.remaining()) )
+        {
+            locked.store(true, std::memory_order_relaxed);
+            parkedAcquisitions.fetch_add(1UL, std::memory_order_relaxed);
+            return true;
+        }
+        return false;
+    }
+
+    /** Unlocks the mutex */
+    void unlockImpl()
+    {
+        locked.store(false, std::memory_order_relaxed);
+        mutex.unlock();
+    }
+
+};
+
+#endif // OSAPI_ADAPTIVE_MUTEX_H
@@ -0,0 +1,49 @@
+#ifndef OSAPI_AFFINITY_H
+#define OSAPI_AFFINITY_H
+
+/** Maximum number of physical cores considered by spreadAcrossCores(), one per bit of AffinityMask. */
+#define OSAPI_MAX_CORES ( sizeof(AffinityMask) * CHAR_BIT )
+
+/** Places each of the given threads on its own physical core, see getPhysicalCores().
+ *  Thread i may run on all hardware threads of core i; with more threads than cores the assignment wraps around.
+ *  Keeping hot threads on fixed cores avoids migrations between cores and the cache refills they cause.
+ *  Can be called before run() (the masks are applied on start) or while the threads are running.
+ *  @param[in] threads array of the threads to place
+ *  @param[in] count number of threads in the array
+ *  @retval true if the affinity of every thread was set
+ *  @retval false if the topology is unknown or a thread rejected its mask
+ */
+inline bool spreadAcrossCores(ThreadInterface* const* threads, unsigned int count)
+{
+    AffinityMask cores[OSAPI_MAX_CORES];
+    unsigned int found = getPhysicalCores(cores, OSAPI_MAX_CORES);
+    if ( found == 0U )
+    {
+        return false;
+    }
+    bool placed = true;
+    for ( unsigned int i = 0U; i < count; i++ )
+    {
+        if ( !threads[i]->setAffinity(cores[i % found]) )
+        {
+            placed = false;
+        }
+    }
+    return placed;
+}
+
+/** Places each of the given threads on its own physical core,
+ *  see spreadAcrossCores(ThreadInterface* const*, unsigned int).
+ *  @param[in] threads threads to place
+ *  @retval true if the affinity of every thread was set
+ *  @retval false if the topology is unknown or a thread rejected its mask
+ */
+template <typename... Threads>
+bool spreadAcrossCores(Threads&... threads)
+{
+    static_assert(sizeof...(Threads) > 0, "spreadAcrossCores needs at least one thread");
+    ThreadInterface* list[] = { &threads... };
+    return spreadAcrossCores(list, sizeof...(Threads));
+}
+
+#endif // OSAPI_AFFINITY_H
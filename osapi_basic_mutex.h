@@ -0,0 +1,74 @@
+#ifndef OSAPI_BASIC_MUTEX_H
+#define OSAPI_BASIC_MUTEX_H
+
+/** Compile-time dispatched base for all mutexes (CRTP).
+ *  The implementation class Impl provides non-virtual lockImpl(unsigned int) and unlockImpl() methods.
+ *  lock() and unlock() are final, so every call made through the concrete mutex type is resolved
+ *  at compile time and can be inlined. MutexInterface stays a thin adapter for code which needs runtime polymorphism.
+ *  With OSAPI_MUTEX_PROFILING defined, every mutex records contention and hold times in a MutexProfile;
+ *  without it the profiling code and the name are compiled out.
+ */
+template <typename Impl>
+class BasicMutex : public MutexInterface
+{
+#ifdef OSAPI_MUTEX_PROFILING
+private:
+    MutexProfile profile;
+#endif
+
+public:
+
+    using MutexInterface::lock;
+
+    /** Mutex base constructor.
+     *  @param[in] name optional name, reported by the mutex profiling
+     */
+    BasicMutex(const char* name = nullptr)
+#ifdef OSAPI_MUTEX_PROFILING
+        : profile(name)
+#endif
+    {
+        (void)name;
+    }
+
+    /** Locks the mutex. In case the mutex is already locked, it may cause the calling thread to block,
+     *  waiting for the mutex to become unlocked, for the maximum given timeout.
+     *  @param[in] timeout maximum number of milliseconds allowed to block the calling thread while waiting for mutex to become unlocked
+     *  @retval true if the mutex was successfully locked (calling thread owns now this lock)
+     *  @retval false if the mutex was not locked within the given time
+     */
+    virtual bool lock(unsigned int timeout) final
+    {
+#ifdef OSAPI_MUTEX_PROFILING
+        Impl* self = static_cast<Impl*>(this);
+        if ( self->lockImpl(0U) )
+        {
+            profile.locked(0ULL);
+            return true;
+        }
+        profile.contention();
+        unsigned long long start = monotonicNanos();
+        if ( timeout != 0U && self->lockImpl(timeout) )
+        {
+            profile.locked(monotonicNanos() - start);
+            return true;
+        }
+        profile.timedOut();
+        return false;
+#else
+        return static_cast<Impl*>(this)->lockImpl(timeout);
+#endif
+    }
+
+    /** Unlocks the mutex */
+    virtual void unlock() final
+    {
+#ifdef OSAPI_MUTEX_PROFILING
+        profile.unlocking();
+#endif
+        static_cast<Impl*>(this)->unlockImpl();
+    }
+
+};
+
+#endif // OSAPI_BASIC_MUTEX_H
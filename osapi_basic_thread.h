@@ -0,0 +1,132 @@
+#ifndef OSAPI_BASIC_THREAD_H
+#define OSAPI_BASIC_THREAD_H
+
+/** Compile-time dispatched base for all threads (CRTP).
+ *  The implementation class Impl provides non-virtual runImpl(), isRunningImpl(), joinImpl(), isJoinableImpl(),
+ *  suspendImpl(), resumeImpl(), setPriorityImpl(), getPriorityImpl(), setAffinityImpl(), getAffinityImpl(),
+ *  getNameImpl() and sleepImpl() methods.
+ *  All ThreadInterface methods are final here, so calls made through the concrete thread type (including sleep()
+ *  called from job()) are resolved at compile time. ThreadInterface stays a thin adapter for runtime polymorphism.
+ *  Impl also provides readStatisticsImpl(ThreadStatistics&) for the ThreadRegistry, and may provide a static
+ *  finishStatisticsImpl(ThreadStatistics&) for the counters read after the registry is unlocked; its thread
+ *  function calls enterRegistry() before and leaveRegistry() after job(), so both run on the thread itself.
+ */
+template <typename Impl>
+class BasicThread : public ThreadInterface
+{
+    public:
+
+        BasicThread() : entry(*this, &BasicThread::readStatistics)
+        {
+        }
+
+        using ThreadInterface::join;
+        using ThreadInterface::setPriority;
+
+        virtual bool run() final
+        {
+            return impl().runImpl();
+        }
+
+        virtual bool isRunning() final
+        {
+            return impl().isRunningImpl();
+        }
+
+        virtual bool join(unsigned int timeout) final
+        {
+            return impl().joinImpl(timeout);
+        }
+
+        virtual bool isJoinable() final
+        {
+            return impl().isJoinableImpl();
+        }
+
+        virtual bool suspend() final
+        {
+            return impl().suspendImpl();
+        }
+
+        virtual bool resume() final
+        {
+            return impl().resumeImpl();
+        }
+
+        virtual bool setPriority(int priority) final
+        {
+            return impl().setPriorityImpl(priority);
+        }
+
+        virtual int getPriority() final
+        {
+            return impl().getPriorityImpl();
+        }
+
+        virtual bool setAffinity(AffinityMask affinity) final
+        {
+            return impl().setAffinityImpl(affinity);
+        }
+
+        virtual AffinityMask getAffinity() final
+        {
+            return impl().getAffinityImpl();
+        }
+
+        virtual const char* getName() final
+        {
+            return impl().getNameImpl();
+        }
+
+        /** Completes counters copied by the ThreadRegistry, called after the registry is unlocked.
+         *  @param[in,out] statistics counters of a thread, which may have exited in the meantime
+         */
+        static void finishStatistics(ThreadStatistics& statistics)
+        {
+            Impl::finishStatisticsImpl(statistics);
+        }
+
+    protected:
+
+        using ThreadInterface::sleep;
+
+        virtual void sleep(unsigned int time) final
+        {
+            impl().sleepImpl(time);
+        }
+
+        /** Adds the thread to the ThreadRegistry, called on the thread itself before job() starts. */
+        void enterRegistry()
+        {
+            registerThread(entry);
+        }
+
+        /** Removes the thread from the ThreadRegistry, called on the thread itself after job() returned. */
+        void leaveRegistry()
+        {
+            unregisterThread(entry);
+        }
+
+        /** Default for backends which read all counters with the registry locked. */
+        static void finishStatisticsImpl(ThreadStatistics& statistics)
+        {
+            (void)statistics;
+        }
+
+    private:
+
+        ThreadEntry entry;
+
+        static void readStatistics(ThreadInterface& thread, ThreadStatistics& statistics)
+        {
+            static_cast<Impl&>(thread).readStatisticsImpl(statistics);
+        }
+
+        Impl& impl()
+        {
+            return *static_cast<Impl*>(this);
+        }
+
+};
+
+#endif // OSAPI_BASIC_THREAD_H
@@ -0,0 +1,88 @@
+#ifndef OSAPI_CONDITION_VARIABLE_H
+#define OSAPI_CONDITION_VARIABLE_H
+
+/** Lets threads block until another thread notifies them about a change of some shared state,
+ *  instead of polling the state in a sleep() loop.
+ *  Works with any mutex (MutexInterface) guarding the state; the mutex has to be locked once by the waiting thread.
+ *  Waiting threads sleep on a sequence word, which every notification advances, so a notification sent
+ *  after the waiter released the mutex can't get lost. Wake-ups may be spurious, use the predicate overload of wait()
+ *  or re-check the state in a loop.
+ */
+class ConditionVariable
+{
+private:
+    std::atomic<unsigned int> sequence;
+    std::atomic<unsigned int> waiters;
+    WaitQueue queue;
+
+public:
+    ConditionVariable() : sequence(0U), waiters(0U)
+    {
+    }
+
+    /** Atomically unlocks the mutex and blocks the calling thread until notified, for the maximum given timeout.
+     *  The mutex is locked again before returning, also on timeout.
+     *  @param[in] mutex mutex locked by the calling thread
+     *  @param[in] timeout maximum number of milliseconds to block the calling thread
+     *  @retval true if the thread was notified (or woken up spuriously)
+     *  @retval false if the timeout expired
+     */
+    bool wait(MutexInterface& mutex, unsigned int timeout)
+    {
+        // read the sequence and register while still holding the mutex, so no notification is missed
+        unsigned int seen = sequence.load();
+        waiters.fetch_add(1U);
+        mutex.unlock();
+        bool notified = queue.wait(sequence, seen, timeout);
+        waiters.fetch_sub(1U);
+        mutex.lock(UINT_MAX);
+        return notified;
+    }
+
+    /** Blocks the calling thread until the predicate holds, for the maximum given timeout.
+     *  The predicate is evaluated with the mutex locked.
+     *  @param[in] mutex mutex locked by the calling thread
+     *  @param[in] timeout maximum number of milliseconds to block the calling thread
+     *  @param[in] predicate callable returning true when the awaited state was reached
+     *  @retval true if the predicate holds
+     *  @retval false if the predicate did not hold within the given time
+     */
+    template <typename Predicate>
+    bool wait(MutexInterface& mutex, unsigned int timeout, Predicate predicate)
+    {
+        Deadline left(timeout);
+        while ( !predicate() )
+        {
+            unsigned int remaining = left.remaining();
+            if ( remaining == 0U )
+            {
+                return false;
+            }
+            wait(mutex, remaining);
+        }
+        return true;
+    }
+
+    /** Wakes up one waiting thread, if there is any. */
+    void notifyOne()
+    {
+        sequence.fetch_add(1U);
+        if ( waiters.load() != 0U )
+        {
+            queue.wakeOne(sequence);
+        }
+    }
+
+    /** Wakes up all waiting threads. */
+    void notifyAll()
+    {
+        sequence.fetch_add(1U);
+        if ( waiters.load() != 0U )
+        {
+            queue.wakeAll(sequence);
+        }
+    }
+
+};
+
+#endif // OSAPI_CONDITION_VARIABLE_H
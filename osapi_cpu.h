@@ -0,0 +1,23 @@
+#ifndef OSAPI_CPU_H
+#define OSAPI_CPU_H
+
+#ifndef OSAPI_CACHE_LINE_SIZE
+/** Size of the CPU cache line, used to keep data written by different threads apart (avoids false sharing). */
+#define OSAPI_CACHE_LINE_SIZE 64
+#endif
+
+/** Tells the CPU that the calling thread is busy-waiting (pause on x86, yield on ARM).
+ *  It lowers the power consumption of a spin loop and frees pipeline resources for the sibling hardware thread.
+ */
+inline void cpuRelax()
+{
+#if defined(_MSC_VER)
+    YieldProcessor();
+#elif defined(__i386__) || defined(__x86_64__)
+    __builtin_ia32_pause();
+#elif defined(__arm__) || defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+#endif // OSAPI_CPU_H
@@ -0,0 +1,113 @@
+#ifndef OSAPI_DEADLINE_H
+#define OSAPI_DEADLINE_H
+
+/** Absolute point in time on the monotonicNanos() clock. Lets several consecutive blocking calls share
+ *  one time budget, instead of each call re-applying a relative timeout.
+ *  Created from a relative timeout in milliseconds; UINT_MAX means a deadline that never expires,
+ *  like INFINITE on Windows or osWaitForever on RTX.
+ */
+class Deadline
+{
+private:
+    static const unsigned long long NEVER = ULLONG_MAX;
+
+    unsigned long long expiry;
+
+    struct Absolute {};
+
+    Deadline(unsigned long long expiry, Absolute) : expiry(expiry)
+    {
+    }
+
+public:
+    /** Deadline constructor, starts counting down immediately.
+     *  @param[in] timeout number of milliseconds from now, UINT_MAX for a deadline that never expires
+     */
+    explicit Deadline(unsigned int timeout)
+        : expiry(timeout == UINT_MAX ? NEVER : monotonicNanos() + (unsigned long long)timeout * 1000000ULL)
+    {
+    }
+
+    /** Creates a deadline that never expires.
+     *  @return infinite deadline
+     */
+    static Deadline never()
+    {
+        return Deadline(NEVER, Absolute());
+    }
+
+    /** Creates a deadline the given number of nanoseconds from now.
+     *  @param[in] nanos number of nanoseconds from now
+     *  @return deadline
+     */
+    static Deadline afterNanos(unsigned long long nanos)
+    {
+        unsigned long long now = monotonicNanos();
+        return Deadline(nanos >= NEVER - now ? NEVER - 1ULL : now + nanos, Absolute());
+    }
+
+    /** Creates a deadline at the given monotonicNanos() value.
+     *  @param[in] nanos absolute point in time in nanoseconds
+     *  @return deadline
+     */
+    static Deadline atNanos(unsigned long long nanos)
+    {
+        return Deadline(nanos == NEVER ? NEVER - 1ULL : nanos, Absolute());
+    }
+
+    /** Checks if the deadline never expires.
+     *  @retval true if the deadline is infinite
+     *  @retval false otherwise
+     */
+    bool isNever() const
+    {
+        return expiry == NEVER;
+    }
+
+    /** Checks if the deadline passed.
+     *  @retval true if the deadline passed
+     *  @retval false otherwise
+     */
+    bool expired() const
+    {
+        return expiry != NEVER && monotonicNanos() >= expiry;
+    }
+
+    /** Gets the number of nanoseconds left.
+     *  @return remaining time in nanoseconds, 0 if the deadline passed, ULLONG_MAX if it never expires
+     */
+    unsigned long long remainingNanos() const
+    {
+        if ( expiry == NEVER )
+        {
+            return NEVER;
+        }
+        unsigned long long now = monotonicNanos();
+        return now >= expiry ? 0ULL : expiry - now;
+    }
+
+    /** Gets the number of milliseconds left, rounded up, as expected by the timeout parameters of this library.
+     *  @return remaining time in milliseconds, 0 if the deadline passed, UINT_MAX if it never expires
+     */
+    unsigned int remaining() const
+    {
+        unsigned long long nanos = remainingNanos();
+        if ( nanos == NEVER )
+        {
+            return UINT_MAX;
+        }
+        unsigned long long millis = (nanos + 999999ULL) / 1000000ULL;
+        return millis >= UINT_MAX ? UINT_MAX - 1U : (unsigned int)millis;
+    }
+
+    /** Gets the point in time of the deadline.
+     *  @return monotonicNanos() value of the deadline, ULLONG_MAX if it never expires
+     */
+    unsigned long long getExpiry() const
+    {
+        return expiry;
+    }
+
+};
+
+#endif // OSAPI_DEADLINE_H
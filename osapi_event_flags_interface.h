@@ -0,0 +1,49 @@
+#ifndef OSAPI_EVENT_FLAGS_INTERFACE_H
+#define OSAPI_EVENT_FLAGS_INTERFACE_H
+
+/** Enumeration describing when a wait for event flags is satisfied */
+typedef enum {
+    WAIT_ANY = 0,
+    WAIT_ALL = 1
+} EventWait;
+
+/** Base interface for event flags: a word of bits which threads can set, clear and wait for.
+ *  FreeRTOS event groups hold 24 bits (8 with configUSE_16_BIT_TICKS), RTX event flags 31 bits,
+ *  use the low bits for portable code.
+ */
+class EventFlagsInterface
+{
+    public:
+
+        /** Virtual destructor required to properly destroy derived class objects. */
+        virtual ~EventFlagsInterface() { }
+
+        /** Sets flags and wakes up the threads whose wait condition got satisfied.
+         *  @param[in] flags bits to set
+         *  @return flags after setting (threads woken up may have cleared some of them already)
+         */
+        virtual unsigned int set(unsigned int flags) = 0;
+
+        /** Clears flags.
+         *  @param[in] flags bits to clear
+         *  @return flags before clearing
+         */
+        virtual unsigned int clear(unsigned int flags) = 0;
+
+        /** Gets the current flags.
+         *  @return current flags
+         */
+        virtual unsigned int get() = 0;
+
+        /** Blocks the calling thread until any or all of the given flags are set, for the maximum given timeout.
+         *  @param[in] flags bits to wait for
+         *  @param[in] mode WAIT_ANY returns when any of the flags is set, WAIT_ALL when all of them are set
+         *  @param[in] clearOnExit clears the awaited flags when the wait is satisfied
+         *  @param[in] timeout maximum number of milliseconds to block the calling thread
+         *  @return flags which satisfied the wait (before clearing), 0 if the wait was not satisfied within the given time
+         */
+        virtual unsigned int wait(unsigned int flags, EventWait mode, bool clearOnExit, unsigned int timeout) = 0;
+
+};
+
+#endif // OSAPI_EVENT_FLAGS_INTERFACE_H
@@ -0,0 +1,321 @@
+#ifndef OSAPI_LOCK_H
+#define OSAPI_LOCK_H
+
+#ifndef OSAPI_LOCK_ALL_MAX_BACKOFF
+/** Upper bound of the busy-wait back-off of lockAll() between two attempts, in cpuRelax() iterations. */
+#define OSAPI_LOCK_ALL_MAX_BACKOFF 1024U
+#endif
+
+/** How UniqueLock treats the mutex passed to its constructor. */
+typedef enum {
+    /** do not lock the mutex yet */
+    DEFER_LOCK = 0,
+    /** try to lock the mutex without blocking */
+    TRY_LOCK = 1
+} LockMode;
+
+/** Tells LockGuard and UniqueLock to take over a mutex the calling thread already locked (e.g. with lockAll()).
+ *  A type of its own, so LockGuard accepts no other LockMode.
+ */
+typedef enum {
+    ADOPT_LOCK = 2
+} AdoptLock;
+
+/** Scoped lock: locks the mutex in the constructor (waiting forever) and unlocks it in the destructor,
+ *  so every return path releases the mutex.
+ *  Works with any type providing lock(unsigned int) and unlock(); with the concrete mutex type the calls are not virtual.
+ */
+template <typename Lockable = MutexInterface>
+class LockGuard
+{
+private:
+    Lockable& mutex;
+
+public:
+    /** Locks the mutex.
+     *  @param[in] mutex mutex to lock
+     */
+    explicit LockGuard(Lockable& mutex) : mutex(mutex)
+    {
+        mutex.lock(UINT_MAX);
+    }
+
+    /** Takes over a mutex the calling thread already locked.
+     *  @param[in] mutex locked mutex
+     *  @param[in] adopt ADOPT_LOCK
+     */
+    LockGuard(Lockable& mutex, AdoptLock adopt) : mutex(mutex)
+    {
+        (void)adopt;
+    }
+
+    ~LockGuard()
+    {
+        mutex.unlock();
+    }
+
+    LockGuard(const LockGuard&) = delete;
+    LockGuard& operator=(const LockGuard&) = delete;
+};
+
+/** Movable scoped lock which may or may not own its mutex. The mutex is unlocked on destruction if it is owned.
+ *  Unlike LockGuard it supports timed, non-blocking and deferred locking, and can be returned from functions.
+ */
+template <typename Lockable = MutexInterface>
+class UniqueLock
+{
+private:
+    Lockable* mutex;
+    bool owned;
+
+public:
+    /** Creates a lock without a mutex. */
+    UniqueLock() : mutex(nullptr), owned(false)
+    {
+    }
+
+    /** Locks the mutex, waiting forever.
+     *  @param[in] mutex mutex to lock
+     */
+    explicit UniqueLock(Lockable& mutex) : mutex(&mutex), owned(false)
+    {
+        owned = mutex.lock(UINT_MAX);
+    }
+
+    /** Locks the mutex, waiting at most for the given time. Check the result with isLocked().
+     *  @param[in] mutex mutex to lock
+     *  @param[in] timeout maximum number of milliseconds to wait for the mutex
+     */
+    UniqueLock(Lockable& mutex, unsigned int timeout) : mutex(&mutex), owned(false)
+    {
+        owned = mutex.lock(timeout);
+    }
+
+    /** Locks the mutex, waiting at most until the deadline. Check the result with isLocked().
+     *  @param[in] mutex mutex to lock
+     *  @param[in] deadline point in time after which the calling thread stops waiting
+     */
+    UniqueLock(Lockable& mutex, const Deadline& deadline) : mutex(&mutex), owned(false)
+    {
+        owned = mutex.lock(deadline.remaining());
+    }
+
+    /** Associates the mutex with the lock without blocking.
+     *  @param[in] mutex mutex to associate
+     *  @param[in] mode DEFER_LOCK leaves it unlocked, TRY_LOCK tries to lock it
+     */
+    UniqueLock(Lockable& mutex, LockMode mode) : mutex(&mutex), owned(false)
+    {
+        if ( mode == TRY_LOCK )
+        {
+            owned = mutex.lock(0U);
+        }
+    }
+
+    /** Takes over a mutex the calling thread already locked.
+     *  @param[in] mutex locked mutex
+     *  @param[in] adopt ADOPT_LOCK
+     */
+    UniqueLock(Lockable& mutex, AdoptLock adopt) : mutex(&mutex), owned(true)
+    {
+        (void)adopt;
+    }
+
+    UniqueLock(UniqueLock&& other) : mutex(other.mutex), owned(other.owned)
+    {
+        other.mutex = nullptr;
+        other.owned = false;
+    }
+
+    UniqueLock& operator=(UniqueLock&& other)
+    {
+        if ( this != &other )
+        {
+            if ( owned )
+            {
+                mutex->unlock();
+            }
+            mutex = other.mutex;
+            owned = other.owned;
+            other.mutex = nullptr;
+            other.owned = false;
+        }
+        return *this;
+    }
+
+    ~UniqueLock()
+    {
+        if ( owned )
+        {
+            mutex->unlock();
+        }
+    }
+
+    UniqueLock(const UniqueLock&) = delete;
+    UniqueLock& operator=(const UniqueLock&) = delete;
+
+    /** Locks the associated mutex.
+     *  @param[in] timeout maximum number of milliseconds to wait for the mutex
+     *  @retval true if the mutex is locked by this lock now
+     *  @retval false if the mutex was not locked in time, there is no mutex, or the lock already owns it
+     */
+    bool lock(unsigned int timeout = UINT_MAX)
+    {
+        if ( mutex == nullptr || owned )
+        {
+            return false;
+        }
+        owned = mutex->lock(timeout);
+        return owned;
+    }
+
+    /** Locks the associated mutex, waiting at most until the deadline.
+     *  @param[in] deadline point in time after which the calling thread stops waiting
+     *  @retval true if the mutex is locked by this lock now
+     *  @retval false otherwise
+     */
+    bool lock(const Deadline& deadline)
+    {
+        return lock(deadline.remaining());
+    }
+
+    /** Tries to lock the associated mutex without blocking.
+     *  @retval true if the mutex is locked by this lock now
+     *  @retval false otherwise
+     */
+    bool tryLock()
+    {
+        return lock(0U);
+    }
+
+    /** Unlocks the associated mutex, if the lock owns it. */
+    void unlock()
+    {
+        if ( owned )
+        {
+            owned = false;
+            mutex->unlock();
+        }
+    }
+
+    /** Dissociates the mutex from the lock without unlocking it.
+     *  @return the mutex (the caller is responsible for unlocking it if it was owned)
+     */
+    Lockable* release()
+    {
+        Lockable* released = mutex;
+        mutex = nullptr;
+        owned = false;
+        return released;
+    }
+
+    /** Checks if the lock owns its mutex.
+     *  @retval true if the mutex is locked by this lock
+     *  @retval false otherwise
+     */
+    bool isLocked() const
+    {
+        return owned;
+    }
+
+    explicit operator bool() const
+    {
+        return owned;
+    }
+
+    /** Gets the associated mutex.
+     *  @return the mutex, nullptr if there is none
+     */
+    Lockable* getMutex() const
+    {
+        return mutex;
+    }
+};
+
+/** Locks all given mutexes without risking a deadlock with other threads locking them in a different order.
+ *  Blocks on one mutex and only tries the others; if one of them is busy, releases everything, backs off and
+ *  starts over by blocking on the busy mutex, so the thread waits where the contention is instead of spinning.
+ *  All attempts share one deadline. The mutexes have to be distinct.
+ *  @param[in] deadline point in time after which the calling thread gives up
+ *  @param[in] mutexes array of the mutexes to lock
+ *  @param[in] count number of mutexes in the array
+ *  @retval true if all mutexes are locked by the calling thread
+ *  @retval false if they could not be locked before the deadline, none of them is locked then
+ */
+inline bool lockAll(const Deadline& deadline, MutexInterface* const* mutexes, unsigned int count)
+{
+    unsigned int first = 0U;
+    unsigned int backoff = 1U;
+    while ( true )
+    {
+        if ( !mutexes[first]->lock(deadline.remaining()) )
+        {
+            return false;
+        }
+        unsigned int busy = count;
+        for ( unsigned int i = 1U; i < count; i++ )
+        {
+            unsigned int index = (first + i) % count;
+            if ( !mutexes[index]->lock(0U) )
+            {
+                busy = index;
+                break;
+            }
+        }
+        if ( busy == count )
+        {
+            return true;
+        }
+
+        // release in reverse order, from the mutex before the busy one back to the first one
+        for ( unsigned int index = busy; index != first; )
+        {
+            index = (index + count - 1U) % count;
+            mutexes[index]->unlock();
+        }
+        if ( deadline.expired() )
+        {
+            return false;
+        }
+        for ( unsigned int i = 0U; i < backoff; i++ )
+        {
+            cpuRelax();
+        }
+        if ( backoff < OSAPI_LOCK_ALL_MAX_BACKOFF )
+        {
+            backoff *= 2U;
+        }
+        first = busy;
+    }
+}
+
+/** Locks all given mutexes within one overall timeout, see lockAll(const Deadline&, MutexInterface* const*, unsigned int).
+ *  Unlock them one by one, or hand them to LockGuard / UniqueLock with ADOPT_LOCK.
+ *  @param[in] timeout maximum number of milliseconds to wait for all mutexes together
+ *  @param[in] mutexes mutexes to lock (derived from MutexInterface)
+ *  @retval true if all mutexes are locked by the calling thread
+ *  @retval false if they could not be locked in time, none of them is locked then
+ */
+template <typename... Mutexes>
+bool lockAll(unsigned int timeout, Mutexes&... mutexes)
+{
+    static_assert(sizeof...(Mutexes) > 0, "lockAll needs at least one mutex");
+    MutexInterface* list[] = { &mutexes... };
+    return lockAll(Deadline(timeout), list, sizeof...(Mutexes));
+}
+
+/** Locks all given mutexes before the deadline, see lockAll(const Deadline&, MutexInterface* const*, unsigned int).
+ *  @param[in] deadline point in time after which the calling thread gives up
+ *  @param[in] mutexes mutexes to lock (derived from MutexInterface)
+ *  @retval true if all mutexes are locked by the calling thread
+ *  @retval false if they could not be locked in time, none of them is locked then
+ */
+template <typename... Mutexes>
+bool lockAll(const Deadline& deadline, Mutexes&... mutexes)
+{
+    static_assert(sizeof...(Mutexes) > 0, "lockAll needs at least one mutex");
+    MutexInterface* list[] = { &mutexes... };
+    return lockAll(deadline, list, sizeof...(Mutexes));
+}
+
+#endif // OSAPI_LOCK_H
@@ -0,0 +1,282 @@
+#ifndef OSAPI_MEMORY_POOL_H
+#define OSAPI_MEMORY_POOL_H
+
+#ifndef ATOMIC_LLONG_LOCK_FREE
+// without <atomic> the test below would silently pick the 32-bit head, include the library through osapi.h
+#error "ATOMIC_LLONG_LOCK_FREE is undefined, osapi_memory_pool.h has to be included after <atomic>"
+#endif
+
+#ifndef OSAPI_MEMORY_POOL_WIDE_HEAD
+/** 1 keeps the free list head of MemoryPool in 64 bits (48-bit tag), 0 in 32 bits (16-bit tag).
+ *  Defaults to 64 bits where 64-bit atomics are lock-free (not on Cortex-M, which has no 64-bit CAS).
+ */
+#if ATOMIC_LLONG_LOCK_FREE == 2
+#define OSAPI_MEMORY_POOL_WIDE_HEAD 1
+#else
+#define OSAPI_MEMORY_POOL_WIDE_HEAD 0
+#endif
+#endif
+
+/** Thread-safe pool of fixed-size memory blocks, carved out of a static arena.
+ *  Free blocks form a lock-free stack. Its head packs a block index with a tag which changes on every
+ *  update, so a compare-and-swap can't succeed on a head that was popped and pushed back in the meantime (ABA).
+ *  The tag has 48 bits with a 64-bit head (OSAPI_MEMORY_POOL_WIDE_HEAD). With a 32-bit head it has 16 bits and
+ *  wraps after 65536 updates: a thread preempted between reading the head and its compare-and-swap, while other
+ *  threads update the pool a multiple of 65536 times, can corrupt the free list. Keep the pool out of such
+ *  workloads on targets without 64-bit atomics, e.g. by not allocating from low priority threads.
+ *  Both allocate() and deallocate() are O(1); allocate() can block while the pool is exhausted.
+ *  @tparam BlockSize size of a single block in bytes
+ *  @tparam Count number of blocks (less than 65535)
+ */
+template <unsigned int BlockSize, unsigned int Count>
+class MemoryPool
+{
+    static_assert(BlockSize != 0U, "MemoryPool block size can't be zero");
+    static_assert(Count != 0U && Count < 0xFFFFU, "MemoryPool holds from 1 to 65534 blocks");
+
+public:
+    /** Distance between two consecutive blocks, the block size rounded up to the maximum alignment. */
+    static const unsigned int BLOCK_STRIDE = (BlockSize + alignof(std::max_align_t) - 1U) / alignof(std::max_align_t) * alignof(std::max_align_t);
+
+private:
+#if OSAPI_MEMORY_POOL_WIDE_HEAD
+    typedef unsigned long long Head;
+#else
+    typedef unsigned int Head;
+#endif
+
+    static const unsigned int NO_BLOCK = 0xFFFFU;
+    static const Head INDEX_MASK = 0xFFFFU;
+    static const Head TAG_INCREMENT = 0x10000U;
+
+    alignas(std::max_align_t) unsigned char arena[BLOCK_STRIDE * Count];
+    std::atomic<unsigned short> next[Count];
+
+    /** free list head: tag in the upper bits, block index in the lower 16 bits */
+    alignas(OSAPI_CACHE_LINE_SIZE) std::atomic<Head> head;
+
+    alignas(OSAPI_CACHE_LINE_SIZE) std::atomic<unsigned int> used;
+    std::atomic<unsigned int> highWater;
+    std::atomic<unsigned int> waiting;
+    std::atomic<unsigned int> releaseEvents;
+    WaitQueue released;
+
+    void* pop()
+    {
+        Head current = head.load(std::memory_order_acquire);
+        unsigned int index;
+        do
+        {
+            index = (unsigned int)(current & INDEX_MASK);
+            if ( index == NO_BLOCK )
+            {
+                return nullptr;
+            }
+        }
+        while ( !head.compare_exchange_weak(current, ((current + TAG_INCREMENT) & ~INDEX_MASK) | next[index].load(std::memory_order_relaxed),
+                                            std::memory_order_acquire, std::memory_order_acquire) );
+
+        unsigned int inUse = used.fetch_add(1U, std::memory_order_relaxed) + 1U;
+        unsigned int peak = highWater.load(std::memory_order_relaxed);
+        while ( inUse > peak && !highWater.compare_exchange_weak(peak, inUse, std::memory_order_relaxed) )
+        {
+        }
+        return &arena[index * BLOCK_STRIDE];
+    }
+
+public:
+    MemoryPool() : head(0U), used(0U), highWater(0U), waiting(0U), releaseEvents(0U)
+    {
+        for ( unsigned int i = 0U; i < Count; i++ )
+        {
+            next[i].store((unsigned short)(i + 1U < Count ? i + 1U : NO_BLOCK), std::memory_order_relaxed);
+        }
+    }
+
+    /** Allocates a block. If the pool is exhausted, blocks the calling thread until a block is released,
+     *  for the maximum given timeout.
+     *  @param[in] timeout maximum number of milliseconds to wait for a free block
+     *  @return pointer to the allocated block, nullptr if no block became free within the given time
+     */
+    void* allocate(unsigned int timeout)
+    {
+        void* block = pop();
+        if ( block != nullptr || timeout == 0U )
+        {
+            return block;
+        }
+
+        Deadline left(timeout);
+        while ( true )
+        {
+            unsigned int remaining = left.remaining();
+            if ( remaining == 0U )
+            {
+                return nullptr;
+            }
+            // announce ourselves before the last check, pairs with the fence in deallocate()
+            unsigned int seen = releaseEvents.load();
+            waiting.fetch_add(1U);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            block = pop();
+            if ( block == nullptr )
+            {
+                released.wait(releaseEvents, seen, remaining);
+            }
+            waiting.fetch_sub(1U);
+            if ( block == nullptr )
+            {
+                block = pop();
+            }
+            if ( block != nullptr )
+            {
+                return block;
+            }
+        }
+    }
+
+    /** Returns a block to the pool.
+     *  @param[in] block pointer obtained from allocate() of this pool, nullptr is ignored
+     */
+    void deallocate(void* block)
+    {
+        if ( block == nullptr )
+        {
+            return;
+        }
+        unsigned int index = (unsigned int)((static_cast<unsigned char*>(block) - arena) / BLOCK_STRIDE);
+        Head current = head.load(std::memory_order_relaxed);
+        do
+        {
+            next[index].store((unsigned short)(current & INDEX_MASK), std::memory_order_relaxed);
+        }
+        while ( !head.compare_exchange_weak(current, ((current + TAG_INCREMENT) & ~INDEX_MASK) | index,
+                                            std::memory_order_release, std::memory_order_relaxed) );
+        used.fetch_sub(1U, std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if ( waiting.load(std::memory_order_relaxed) != 0U )
+        {
+            releaseEvents.fetch_add(1U);
+            released.wakeOne(releaseEvents);
+        }
+    }
+
+    /** Checks if the given pointer points into this pool.
+     *  @param[in] block pointer to check
+     *  @retval true if the pointer belongs to a block of this pool
+     *  @retval false otherwise
+     */
+    bool owns(const void* block)
+    {
+        const unsigned char* address = static_cast<const unsigned char*>(block);
+        return address >= arena && address < arena + sizeof(arena);
+    }
+
+    /** Gets the number of allocated blocks.
+     *  @return number of blocks currently in use
+     */
+    unsigned int getUsed()
+    {
+        return used.load(std::memory_order_relaxed);
+    }
+
+    /** Gets the highest number of blocks that were in use at the same time.
+     *  @return high-water mark of the pool usage
+     */
+    unsigned int getHighWater()
+    {
+        return highWater.load(std::memory_order_relaxed);
+    }
+
+    /** Gets the number of blocks in the pool.
+     *  @return total number of blocks
+     */
+    unsigned int getCapacity()
+    {
+        return Count;
+    }
+
+    /** Gets the size of a single block.
+     *  @return usable size of a block in bytes
+     */
+    unsigned int getBlockSize()
+    {
+        return BlockSize;
+    }
+
+};
+
+/** STL-compatible allocator drawing single objects from a MemoryPool.
+ *  Suits node based containers (std::list, std::map, std::set, ...), whose nodes fit into one block.
+ *  Requests which don't fit into a block, or which can't be served within the timeout,
+ *  throw std::bad_alloc (or abort when exceptions are disabled).
+ *  @tparam T allocated type
+ *  @tparam Pool MemoryPool instantiation
+ */
+template <typename T, typename Pool>
+class PoolAllocator
+{
+public:
+    typedef T value_type;
+
+    template <typename U>
+    struct rebind
+    {
+        typedef PoolAllocator<U, Pool> other;
+    };
+
+    Pool* pool;
+    unsigned int timeout;
+
+    /** Allocator constructor.
+     *  @param[in] pool pool the objects are taken from
+     *  @param[in] timeout maximum number of milliseconds to wait for a free block
+     */
+    PoolAllocator(Pool& pool, unsigned int timeout = 0U) : pool(&pool), timeout(timeout)
+    {
+    }
+
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U, Pool>& other) : pool(other.pool), timeout(other.timeout)
+    {
+    }
+
+    T* allocate(std::size_t n)
+    {
+        if ( n * sizeof(T) <= pool->getBlockSize() )
+        {
+            void* block = pool->allocate(timeout);
+            if ( block != nullptr )
+            {
+                return static_cast<T*>(block);
+            }
+        }
+#if defined(__cpp_exceptions) || defined(_CPPUNWIND)
+        throw std::bad_alloc();
+#else
+        abort();
+#endif
+    }
+
+    void deallocate(T* object, std::size_t n)
+    {
+        (void)n;
+        pool->deallocate(object);
+    }
+
+    template <typename U>
+    bool operator==(const PoolAllocator<U, Pool>& other) const
+    {
+        return pool == other.pool;
+    }
+
+    template <typename U>
+    bool operator!=(const PoolAllocator<U, Pool>& other) const
+    {
+        return pool != other.pool;
+    }
+
+};
+
+#endif // OSAPI_MEMORY_POOL_H
@@ -1,37 +1,211 @@
 #ifndef OSAPI_MORTAL_THREAD_H
 #define OSAPI_MORTAL_THREAD_H
 
-class MortalThread : public Thread
+/** Compile-time dispatched mortal thread (CRTP).
+ *  Derived provides begin(), loop() and end() methods, which are called without virtual dispatch,
+ *  so a short loop() body can be inlined into the thread main loop. Derived has to make them
+ *  accessible to this class (make them public or declare BasicMortalThread<Derived> a friend).
+ *  Termination is requested with an atomic stop token; loop() bodies that have to wait should use
+ *  sleepOrKilled() or waitForKill(), which return as soon as kill() is called. The thread is woken up with
+ *  Thread::sendWakeUp() (a task notification on FreeRTOS, a thread flag on RTX), so no kernel object is created.
+ *  Derived may also replace mainLoop() to control how loop() is scheduled (see PeriodicThread).
+ *  With setPublishedReader() the loop() boundaries become quiescent points for reading Published values.
+ */
+template <typename Derived>
+class BasicMortalThread : public Thread
 {
 	private:
-		sig_atomic_t killSignal = 0;
+		/** kill() was called */
+		static const unsigned int KILL_REQUESTED = 1U;
+		/** the thread waits in waitForKill() and has to be woken up */
+		static const unsigned int KILL_WAITING = 2U;
+
+		std::atomic<unsigned int> killSignal;
+		PublishedReader* publishedReader;
 		
 		/** Implementation of the job method */
 		virtual void job()
 		{
-			killSignal = 0;
-			begin();
-			while ( killSignal == 0 )
+			Derived* self = static_cast<Derived*>(this);
+			if ( publishedReader != nullptr )
+			{
+				publishedReader->online();
+			}
+			self->begin();
+			self->mainLoop();
+			std::atomic_thread_fence(std::memory_order_acquire);
+			self->end();
+			if ( publishedReader != nullptr )
 			{
-				loop();
+				publishedReader->offline();
 			}
-			end();
+			// the thread may be run again
+			killSignal.store(0U, std::memory_order_relaxed);
 		}
 	
 	public:
-    MortalThread(int priority, unsigned int stackSize, const char* name = "unnamed") : Thread(priority, stackSize, JOINABLE, name)
+    BasicMortalThread(int priority, unsigned int stackSize, const char* name = "unnamed") : Thread(priority, stackSize, JOINABLE, name), killSignal(0U), publishedReader(nullptr)
 	{
-		killSignal = 0;
 	}
 
-    virtual ~MortalThread() {}
+    /** Constructor for statically allocated mortal threads, see the matching Thread constructor. */
+    BasicMortalThread(int priority, unsigned int stackSize, void* stackMemory, ThreadControlBlock* controlBlock, const char* name = "unnamed")
+		: Thread(priority, stackSize, JOINABLE, stackMemory, controlBlock, name), killSignal(0U), publishedReader(nullptr)
+	{
+	}
+
+    /** Constructors taking a portable priority level, mapped with nativePriority(). */
+    BasicMortalThread(Priority priority, unsigned int stackSize, const char* name = "unnamed")
+		: BasicMortalThread(nativePriority(priority), stackSize, name)
+	{
+	}
 
-    /** Sends termination signal to the thread. */
+    BasicMortalThread(Priority priority, unsigned int stackSize, void* stackMemory, ThreadControlBlock* controlBlock, const char* name = "unnamed")
+		: BasicMortalThread(nativePriority(priority), stackSize, stackMemory, controlBlock, name)
+	{
+	}
+
+    virtual ~BasicMortalThread() {}
+
+    /** Sends termination signal to the thread, waking it up if it waits in sleepOrKilled() or waitForKill(). */
     void kill()
 	{
-		killSignal = 1;
+		// only a waiting thread gets a wake-up, and it takes the wake-up before it may exit
+		if ( ( killSignal.fetch_or(KILL_REQUESTED) & ( KILL_REQUESTED | KILL_WAITING ) ) == KILL_WAITING )
+		{
+			sendWakeUp(killSignal);
+		}
+    }
+
+    /** Sends termination signal to the thread and waits for it to finish executing.
+     *  @param[in] timeout number of milliseconds to wait for the thread to finish executing
+     *  @retval true if the thread was successfully joined in the given time
+     *  @retval false if the thread was not joined within the given time
+     */
+    bool killAndJoin(unsigned int timeout)
+	{
+		kill();
+		return join(timeout);
     }
 
+    /** Checks if termination of the thread was requested.
+     *  @retval true if kill() was called
+     *  @retval false otherwise
+     */
+    bool isKilled()
+	{
+		return ( killSignal.load(std::memory_order_acquire) & KILL_REQUESTED ) != 0U;
+    }
+
+	protected:
+		/** Calls loop() until termination of the thread is requested. */
+		void mainLoop()
+		{
+			Derived* self = static_cast<Derived*>(this);
+			while ( ( killSignal.load(std::memory_order_relaxed) & KILL_REQUESTED ) == 0U )
+			{
+				self->loop();
+				quiescentPoint();
+			}
+		}
+
+		/** Uses the reader for Published values read by the thread: it is online from begin() to end(),
+		 *  and every return from loop() is a quiescent point, so versions read in loop() may be used
+		 *  without guards until loop() returns, and must not be kept across loop() calls.
+		 *  Versions replaced while the thread waits (e.g. in sleepOrKilled()) are reclaimed after its next loop().
+		 *  Call it before run(); the reader has to outlive the thread.
+		 *  @param[in] reader reader owned by this thread, nullptr to stop using one
+		 */
+		void setPublishedReader(PublishedReader* reader)
+		{
+			publishedReader = reader;
+		}
+
+		/** Tells the writers of Published values that the thread holds no version, see setPublishedReader(). */
+		void quiescentPoint()
+		{
+			if ( publishedReader != nullptr )
+			{
+				publishedReader->quiescent();
+			}
+		}
+
+		/** Waits until termination of the thread is requested, for the maximum given time.
+		 *  @param[in] timeout maximum number of milliseconds to wait
+		 *  @retval true if kill() was called
+		 *  @retval false if the time elapsed without a termination request
+		 */
+		bool waitForKill(unsigned int timeout)
+		{
+			return waitForKill(Deadline(timeout));
+		}
+
+		/** Waits until termination of the thread is requested, at most until the deadline.
+		 *  @param[in] left deadline of the wait
+		 *  @retval true if kill() was called
+		 *  @retval false if the deadline passed without a termination request
+		 */
+		bool waitForKill(const Deadline& left)
+		{
+			unsigned int state = 0U;
+			// announce the wait, so kill() knows it has to wake up the thread
+			if ( !killSignal.compare_exchange_strong(state, KILL_WAITING) )
+			{
+				return true;
+			}
+			bool woken = waitForWakeUp(killSignal, KILL_WAITING, left);
+			if ( ( killSignal.fetch_and(~KILL_WAITING) & KILL_REQUESTED ) == 0U )
+			{
+				return false;
+			}
+			if ( !woken )
+			{
+				// kill() came with the deadline and still sends the wake-up, take it before the thread may exit
+				waitForWakeUp(killSignal, KILL_WAITING, Deadline(UINT_MAX));
+			}
+			return true;
+		}
+
+		/** Delays thread execution for a given time, unless termination is requested in the meantime.
+		 *  @param[in] time number of milliseconds to delay thread execution
+		 *  @retval true if the thread slept for the whole time
+		 *  @retval false if the thread was woken up by kill()
+		 */
+		bool sleepOrKilled(unsigned int time)
+		{
+			return waitForKill(time) ? false : true;
+		}
+
+};
+
+class MortalThread : public BasicMortalThread<MortalThread>
+{
+	friend class BasicMortalThread<MortalThread>;
+
+	public:
+    MortalThread(int priority, unsigned int stackSize, const char* name = "unnamed") : BasicMortalThread<MortalThread>(priority, stackSize, name)
+	{
+	}
+
+    /** Constructor for statically allocated mortal threads, see the matching Thread constructor. */
+    MortalThread(int priority, unsigned int stackSize, void* stackMemory, ThreadControlBlock* controlBlock, const char* name = "unnamed")
+		: BasicMortalThread<MortalThread>(priority, stackSize, stackMemory, controlBlock, name)
+	{
+	}
+
+    /** Constructors taking a portable priority level, mapped with nativePriority(). */
+    MortalThread(Priority priority, unsigned int stackSize, const char* name = "unnamed")
+		: MortalThread(nativePriority(priority), stackSize, name)
+	{
+	}
+
+    MortalThread(Priority priority, unsigned int stackSize, void* stackMemory, ThreadControlBlock* controlBlock, const char* name = "unnamed")
+		: MortalThread(nativePriority(priority), stackSize, stackMemory, controlBlock, name)
+	{
+	}
+
+    virtual ~MortalThread() {}
+
 	protected:
 		virtual void begin(void) = 0;
 		virtual void loop(void) = 0;
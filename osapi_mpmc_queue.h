@@ -0,0 +1,236 @@
+#ifndef OSAPI_MPMC_QUEUE_H
+#define OSAPI_MPMC_QUEUE_H
+
+/** Bounded multi-producer, multi-consumer queue with a capacity chosen at runtime.
+ *  Every slot carries a sequence number telling whether it is ready to be written or read
+ *  (D. Vyukov's bounded queue), so producers and consumers only meet on the slot they use
+ *  and on their own position counter, instead of sharing one lock.
+ *  push()/pop() block with the same millisecond timeout convention as MutexInterface::lock().
+ *  close() wakes up all blocked threads; call it next to MortalThread::kill() so that workers
+ *  blocked in pop() notice the termination request immediately.
+ *  @tparam T type of the items, has to be default constructible and copy assignable
+ */
+template <typename T>
+class MpmcQueue
+{
+private:
+    struct Cell
+    {
+        std::atomic<unsigned int> sequence;
+        T data;
+    };
+
+    Cell* cells;
+    unsigned int mask;
+
+    alignas(OSAPI_CACHE_LINE_SIZE) std::atomic<unsigned int> enqueuePosition;
+    alignas(OSAPI_CACHE_LINE_SIZE) std::atomic<unsigned int> dequeuePosition;
+
+    // blocking push() / pop() support
+    alignas(OSAPI_CACHE_LINE_SIZE) std::atomic<bool> closed;
+    std::atomic<unsigned int> producersWaiting;
+    std::atomic<unsigned int> consumersWaiting;
+    std::atomic<unsigned int> notFullEvents;
+    std::atomic<unsigned int> notEmptyEvents;
+    WaitQueue notFull;
+    WaitQueue notEmpty;
+
+    /** Wakes up one thread blocked on the given event, if there is any. */
+    static void signal(std::atomic<unsigned int>& waiting, std::atomic<unsigned int>& events, WaitQueue& queue)
+    {
+        // pairs with the fence in waitFor(): either the waiter sees the new item, or we see the waiter
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if ( waiting.load(std::memory_order_relaxed) != 0U )
+        {
+            events.fetch_add(1U);
+            queue.wakeOne(events);
+        }
+    }
+
+    /** Blocks the calling thread until the given operation succeeds, the queue is closed or the timeout expires. */
+    template <typename Operation>
+    bool waitFor(Operation operation, std::atomic<unsigned int>& waiting, std::atomic<unsigned int>& events,
+                 WaitQueue& queue, unsigned int timeout)
+    {
+        Deadline left(timeout);
+        while ( !operation() )
+        {
+            unsigned int remaining = left.remaining();
+            if ( remaining == 0U || closed.load() )
+            {
+                return false;
+            }
+            unsigned int seen = events.load();
+            waiting.fetch_add(1U);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if ( operation() )
+            {
+                waiting.fetch_sub(1U);
+                return true;
+            }
+            if ( !closed.load() )
+            {
+                queue.wait(events, seen, remaining);
+            }
+            waiting.fetch_sub(1U);
+        }
+        return true;
+    }
+
+public:
+    /** Queue constructor.
+     *  @param[in] capacity minimum number of items the queue can hold, rounded up to a power of two
+     */
+    MpmcQueue(unsigned int capacity)
+        : enqueuePosition(0U), dequeuePosition(0U), closed(false), producersWaiting(0U), consumersWaiting(0U),
+          notFullEvents(0U), notEmptyEvents(0U)
+    {
+        unsigned int size = 2U;
+        while ( size < capacity )
+        {
+            size <<= 1U;
+        }
+        mask = size - 1U;
+        cells = new Cell[size];
+        for ( unsigned int i = 0U; i < size; i++ )
+        {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ~MpmcQueue()
+    {
+        delete[] cells;
+    }
+
+    MpmcQueue(const MpmcQueue&) = delete;
+    MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+    /** Pushes an item, if there is room for it.
+     *  @param[in] item item to be copied into the queue
+     *  @retval true if the item was pushed
+     *  @retval false if the queue is full or closed
+     */
+    bool tryPush(const T& item)
+    {
+        if ( closed.load(std::memory_order_relaxed) )
+        {
+            return false;
+        }
+        Cell* cell;
+        unsigned int position = enqueuePosition.load(std::memory_order_relaxed);
+        while ( true )
+        {
+            cell = &cells[position & mask];
+            int difference = (int)(cell->sequence.load(std::memory_order_acquire) - position);
+            if ( difference == 0 )
+            {
+                if ( enqueuePosition.compare_exchange_weak(position, position + 1U, std::memory_order_relaxed) )
+                {
+                    break;
+                }
+            }
+            else if ( difference < 0 )
+            {
+                return false;
+            }
+            else
+            {
+                position = enqueuePosition.load(std::memory_order_relaxed);
+            }
+        }
+        cell->data = item;
+        cell->sequence.store(position + 1U, std::memory_order_release);
+        signal(consumersWaiting, notEmptyEvents, notEmpty);
+        return true;
+    }
+
+    /** Pops an item, if there is any. Items pushed before close() can still be popped.
+     *  @param[out] item storage for the popped item
+     *  @retval true if an item was popped
+     *  @retval false if the queue is empty
+     */
+    bool tryPop(T& item)
+    {
+        Cell* cell;
+        unsigned int position = dequeuePosition.load(std::memory_order_relaxed);
+        while ( true )
+        {
+            cell = &cells[position & mask];
+            int difference = (int)(cell->sequence.load(std::memory_order_acquire) - (position + 1U));
+            if ( difference == 0 )
+            {
+                if ( dequeuePosition.compare_exchange_weak(position, position + 1U, std::memory_order_relaxed) )
+                {
+                    break;
+                }
+            }
+            else if ( difference < 0 )
+            {
+                return false;
+            }
+            else
+            {
+                position = dequeuePosition.load(std::memory_order_relaxed);
+            }
+        }
+        item = cell->data;
+        cell->sequence.store(position + mask + 1U, std::memory_order_release);
+        signal(producersWaiting, notFullEvents, notFull);
+        return true;
+    }
+
+    /** Pushes an item, blocking the calling thread while the queue is full, for the maximum given timeout.
+     *  @param[in] item item to be copied into the queue
+     *  @param[in] timeout maximum number of milliseconds to wait for a free slot
+     *  @retval true if the item was pushed
+     *  @retval false if the queue stayed full within the given time or it was closed
+     */
+    bool push(const T& item, unsigned int timeout)
+    {
+        return waitFor([&]() { return tryPush(item); }, producersWaiting, notFullEvents, notFull, timeout);
+    }
+
+    /** Pops an item, blocking the calling thread while the queue is empty, for the maximum given timeout.
+     *  @param[out] item storage for the popped item
+     *  @param[in] timeout maximum number of milliseconds to wait for an item
+     *  @retval true if an item was popped
+     *  @retval false if the queue stayed empty within the given time or it was closed and drained
+     */
+    bool pop(T& item, unsigned int timeout)
+    {
+        return waitFor([&]() { return tryPop(item); }, consumersWaiting, notEmptyEvents, notEmpty, timeout);
+    }
+
+    /** Closes the queue: further pushes fail and all blocked threads are woken up.
+     *  Items already in the queue can still be popped.
+     */
+    void close()
+    {
+        closed.store(true);
+        notFullEvents.fetch_add(1U);
+        notFull.wakeAll(notFullEvents);
+        notEmptyEvents.fetch_add(1U);
+        notEmpty.wakeAll(notEmptyEvents);
+    }
+
+    /** Checks if the queue was closed.
+     *  @retval true if close() was called
+     *  @retval false otherwise
+     */
+    bool isClosed()
+    {
+        return closed.load();
+    }
+
+    /** Gets the capacity of the queue.
+     *  @return maximum number of items the queue can hold
+     */
+    unsigned int capacity()
+    {
+        return mask + 1U;
+    }
+
+};
+
+#endif // OSAPI_MPMC_QUEUE_H
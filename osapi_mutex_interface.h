@@ -17,6 +17,16 @@ public:
      */
     virtual bool lock(unsigned int timeout) = 0;
 
+    /** Locks the mutex, blocking the calling thread at most until the given deadline.
+     *  @param[in] deadline point in time after which the calling thread stops waiting for the mutex
+     *  @retval true if the mutex was successfully locked (calling thread owns now this lock)
+     *  @retval false if the mutex was not locked before the deadline
+     */
+    bool lock(const Deadline& deadline)
+    {
+        return lock(deadline.remaining());
+    }
+
     /** Unlocks the mutex */
     virtual void unlock() = 0;
 
@@ -0,0 +1,170 @@
+#ifndef OSAPI_MUTEX_PROFILE_H
+#define OSAPI_MUTEX_PROFILE_H
+
+#ifdef OSAPI_MUTEX_PROFILING
+
+#ifndef OSAPI_MUTEX_PROFILING_BUCKETS
+/** Number of histogram buckets; bucket i counts times from 2^i to 2^(i+1) nanoseconds, the last one everything above. */
+#define OSAPI_MUTEX_PROFILING_BUCKETS 32U
+#endif
+
+/** Copy of the counters of one profiled mutex, see MutexRegistry::snapshot(). Times are in nanoseconds. */
+struct MutexStatistics
+{
+    const char* name;
+    /** number of successful lock() calls */
+    unsigned long acquisitions;
+    /** number of lock() calls which found the mutex locked */
+    unsigned long contended;
+    /** number of lock() calls which did not get the mutex within the timeout */
+    unsigned long timeouts;
+    unsigned long maxWait;
+    unsigned long maxHold;
+    /** time spent in lock() (uncontended acquisitions land in bucket 0) */
+    unsigned long waitHistogram[OSAPI_MUTEX_PROFILING_BUCKETS];
+    /** time from the (outermost) lock() to the matching unlock() */
+    unsigned long holdHistogram[OSAPI_MUTEX_PROFILING_BUCKETS];
+};
+
+class MutexProfile;
+
+inline void registerMutexProfile(MutexProfile& profile);
+inline void unregisterMutexProfile(MutexProfile& profile);
+
+/** Contention counters kept by every mutex when OSAPI_MUTEX_PROFILING is defined.
+ *  Updated with relaxed atomics, so a snapshot taken by another thread is consistent per counter only.
+ */
+class MutexProfile
+{
+    template <typename Entry>
+    friend class Registry;
+
+private:
+    const char* namE;
+    MutexProfile* next;
+    MutexProfile** link;
+    std::atomic<unsigned long> acquisitions;
+    std::atomic<unsigned long> contended;
+    std::atomic<unsigned long> timeouts;
+    std::atomic<unsigned long> maxWait;
+    std::atomic<unsigned long> maxHold;
+    std::atomic<unsigned long> waitHistogram[OSAPI_MUTEX_PROFILING_BUCKETS];
+    std::atomic<unsigned long> holdHistogram[OSAPI_MUTEX_PROFILING_BUCKETS];
+    /** lock depth and start of the hold time, only touched by the owner of the mutex */
+    unsigned int depth;
+    unsigned long long holdStart;
+
+    static unsigned long saturate(unsigned long long nanos)
+    {
+        return nanos > (unsigned long long)ULONG_MAX ? ULONG_MAX : (unsigned long)nanos;
+    }
+
+    static void add(std::atomic<unsigned long>* histogram, std::atomic<unsigned long>& maximum, unsigned long nanos)
+    {
+        unsigned int bucket = 0U;
+        while ( bucket + 1U < OSAPI_MUTEX_PROFILING_BUCKETS && (nanos >> (bucket + 1U)) != 0UL )
+        {
+            bucket++;
+        }
+        histogram[bucket].fetch_add(1UL, std::memory_order_relaxed);
+        unsigned long current = maximum.load(std::memory_order_relaxed);
+        while ( nanos > current && !maximum.compare_exchange_weak(current, nanos, std::memory_order_relaxed) )
+        {
+        }
+    }
+
+public:
+    /** Profile constructor, registers the profile in the MutexRegistry.
+     *  @param[in] name name reported for the mutex, nullptr for "unnamed"
+     */
+    MutexProfile(const char* name) : namE(name != nullptr ? name : "unnamed"), next(nullptr), link(nullptr), depth(0U), holdStart(0ULL)
+    {
+        reset();
+        registerMutexProfile(*this);
+    }
+
+    ~MutexProfile()
+    {
+        unregisterMutexProfile(*this);
+    }
+
+    /** Records a successful lock().
+     *  @param[in] wait nanoseconds spent waiting for the mutex
+     */
+    void locked(unsigned long long wait)
+    {
+        acquisitions.fetch_add(1UL, std::memory_order_relaxed);
+        add(waitHistogram, maxWait, saturate(wait));
+        if ( depth++ == 0U )
+        {
+            holdStart = monotonicNanos();
+        }
+    }
+
+    /** Records a lock() which found the mutex locked, before the calling thread waits. */
+    void contention()
+    {
+        contended.fetch_add(1UL, std::memory_order_relaxed);
+    }
+
+    /** Records a lock() which did not get the mutex within the timeout. */
+    void timedOut()
+    {
+        timeouts.fetch_add(1UL, std::memory_order_relaxed);
+    }
+
+    /** Records an unlock(), called while the mutex is still locked. */
+    void unlocking()
+    {
+        if ( depth != 0U && --depth == 0U )
+        {
+            add(holdHistogram, maxHold, saturate(monotonicNanos() - holdStart));
+        }
+    }
+
+    /** Copies the counters.
+     *  @param[out] statistics storage for the copy
+     */
+    void read(MutexStatistics& statistics)
+    {
+        statistics.name = namE;
+        statistics.acquisitions = acquisitions.load(std::memory_order_relaxed);
+        statistics.contended = contended.load(std::memory_order_relaxed);
+        statistics.timeouts = timeouts.load(std::memory_order_relaxed);
+        statistics.maxWait = maxWait.load(std::memory_order_relaxed);
+        statistics.maxHold = maxHold.load(std::memory_order_relaxed);
+        for ( unsigned int i = 0U; i < OSAPI_MUTEX_PROFILING_BUCKETS; i++ )
+        {
+            statistics.waitHistogram[i] = waitHistogram[i].load(std::memory_order_relaxed);
+            statistics.holdHistogram[i] = holdHistogram[i].load(std::memory_order_relaxed);
+        }
+    }
+
+    /** Clears the counters. */
+    void reset()
+    {
+        acquisitions.store(0UL, std::memory_order_relaxed);
+        contended.store(0UL, std::memory_order_relaxed);
+        timeouts.store(0UL, std::memory_order_relaxed);
+        maxWait.store(0UL, std::memory_order_relaxed);
+        maxHold.store(0UL, std::memory_order_relaxed);
+        for ( unsigned int i = 0U; i < OSAPI_MUTEX_PROFILING_BUCKETS; i++ )
+        {
+            waitHistogram[i].store(0UL, std::memory_order_relaxed);
+            holdHistogram[i].store(0UL, std::memory_order_relaxed);
+        }
+    }
+
+    /** Gets the name of the profiled mutex.
+     *  @return mutex name
+     */
+    const char* getName()
+    {
+        return namE;
+    }
+
+};
+
+#endif // OSAPI_MUTEX_PROFILING
+
+#endif // OSAPI_MUTEX_PROFILE_H
@@ -0,0 +1,114 @@
+#ifndef OSAPI_MUTEX_REGISTRY_H
+#define OSAPI_MUTEX_REGISTRY_H
+
+#ifdef OSAPI_MUTEX_PROFILING
+
+/** Global list of all profiled mutexes (OSAPI_MUTEX_PROFILING), which a diagnostics thread can snapshot or dump.
+ *  Mutexes register on construction and leave on destruction; getCount() tells the number of live mutexes.
+ *  The registry is guarded by an InternalLock, as the registry can't profile itself.
+ */
+class MutexRegistry : public Registry<MutexProfile>
+{
+private:
+    friend class StaticInstance<MutexRegistry>;
+
+    MutexRegistry()
+    {
+    }
+
+public:
+    /** Gets the registry. It is created on first use and never destroyed,
+     *  so mutexes with static storage duration can register and leave in any order.
+     *  @return the global registry
+     */
+    static MutexRegistry& instance()
+    {
+        return StaticInstance<MutexRegistry>::get();
+    }
+
+    /** Copies the counters of the registered mutexes.
+     *  @param[out] statistics array receiving the copies
+     *  @param[in] max size of the array
+     *  @return number of copied entries
+     */
+    unsigned int snapshot(MutexStatistics* statistics, unsigned int max)
+    {
+        unsigned int copied = 0U;
+        forEach([&](MutexProfile& profile) -> bool {
+            if ( copied == max )
+            {
+                return false;
+            }
+            profile.read(statistics[copied++]);
+            return true;
+        });
+        return copied;
+    }
+
+    /** Clears the counters of all registered mutexes. */
+    void reset()
+    {
+        forEach([](MutexProfile& profile) -> bool {
+            profile.reset();
+            return true;
+        });
+    }
+
+    /** Formats the counters of all registered mutexes, one text line per mutex (without line break):
+     *  name, counters, maximum times and the non-empty histogram buckets as log2(nanoseconds):count.
+     *  The writer is called with the registry locked, it must not create or destroy profiled mutexes.
+     *  @param[in] writer callable taking a const char* line
+     */
+    template <typename Writer>
+    void dump(Writer writer)
+    {
+        MutexStatistics statistics;
+        char line[512];
+        forEach([&](MutexProfile& profile) -> bool {
+            profile.read(statistics);
+            int length = snprintf(line, sizeof(line), "%s acquisitions=%lu contended=%lu timeouts=%lu maxWait=%luns maxHold=%luns wait=",
+                                  statistics.name, statistics.acquisitions, statistics.contended, statistics.timeouts,
+                                  statistics.maxWait, statistics.maxHold);
+            length = clamp(length, sizeof(line));
+            length += format(line + length, sizeof(line) - length, statistics.waitHistogram);
+            length = clamp(length + snprintf(line + length, sizeof(line) - length, " hold="), sizeof(line));
+            format(line + length, sizeof(line) - length, statistics.holdHistogram);
+            writer((const char*)line);
+            return true;
+        });
+    }
+
+private:
+    static int clamp(int length, size_t size)
+    {
+        return (size_t)length < size ? length : (int)size - 1;
+    }
+
+    static int format(char* buffer, size_t size, const unsigned long* histogram)
+    {
+        int length = 0;
+        for ( unsigned int i = 0U; i < OSAPI_MUTEX_PROFILING_BUCKETS; i++ )
+        {
+            if ( histogram[i] != 0UL && (size_t)length < size )
+            {
+                length += snprintf(buffer + length, size - length, "%s%u:%lu", length != 0 ? "," : "", i, histogram[i]);
+            }
+        }
+        return clamp(length, size);
+    }
+
+};
+
+inline void registerMutexProfile(MutexProfile& profile)
+{
+    MutexRegistry::instance().add(profile);
+}
+
+inline void unregisterMutexProfile(MutexProfile& profile)
+{
+    MutexRegistry::instance().remove(profile);
+}
+
+#endif // OSAPI_MUTEX_PROFILING
+
+#endif // OSAPI_MUTEX_REGISTRY_H
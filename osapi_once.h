@@ -0,0 +1,114 @@
+#ifndef OSAPI_ONCE_H
+#define OSAPI_ONCE_H
+
+/** Flag for callOnce(), records whether the one-time initialization ran.
+ *  Constant-initialized, so it can guard objects with static storage that are constructed before the scheduler
+ *  (or, on RTX, before osKernelInitialize()) and initialized on first use.
+ */
+class OnceFlag
+{
+private:
+    template <typename Function>
+    friend bool tryCallOnce(OnceFlag& flag, Function&& function);
+
+    static const unsigned int NEW = 0U;
+    static const unsigned int RUNNING = 1U;
+    static const unsigned int WAITING = 2U;
+    static const unsigned int DONE = 3U;
+
+    std::atomic<unsigned int> state;
+
+    /** Wait queue shared by all flags, created on the first contended initialization only
+     *  (i.e. when threads are already running), so an uncontended callOnce() creates no kernel object.
+     *  Not a function-local static, callOnce() has to work with -fno-threadsafe-statics.
+     *  @return the wait queue
+     */
+    static WaitQueue& waiters()
+    {
+        return StaticInstance<WaitQueue, OnceFlag>::get();
+    }
+
+    /** Waits until the thread running the initialization finished it or gave up. */
+    void wait()
+    {
+        unsigned int current = state.load(std::memory_order_acquire);
+        while ( current == RUNNING || current == WAITING )
+        {
+            // announce the waiter, so the initializing thread only wakes up the queue when needed
+            if ( current == RUNNING && !state.compare_exchange_weak(current, WAITING) )
+            {
+                continue;
+            }
+            waiters().wait(state, WAITING, UINT_MAX);
+            current = state.load(std::memory_order_acquire);
+        }
+    }
+
+public:
+    constexpr OnceFlag() : state(NEW)
+    {
+    }
+
+    /** Checks if the initialization guarded by the flag completed.
+     *  @retval true if callOnce() finished running the function (or tryCallOnce() succeeded)
+     *  @retval false otherwise
+     */
+    bool isDone() const
+    {
+        return state.load(std::memory_order_acquire) == DONE;
+    }
+
+    OnceFlag(const OnceFlag&) = delete;
+    OnceFlag& operator=(const OnceFlag&) = delete;
+};
+
+/** Runs the function until it succeeded once per flag, even if several threads call it concurrently.
+ *  Threads arriving while the function runs block until it returned. If it failed, the flag stays unset and
+ *  the next caller (or one of the blocked threads) runs the function again; once it succeeded, every call only
+ *  does a single acquire load and the effects of the function are visible to the caller.
+ *  The function must not call tryCallOnce() or callOnce() on the same flag.
+ *  @param[in] flag flag recording the initialization
+ *  @param[in] function function (or lambda) performing the initialization, returns true on success
+ *  @retval true if the initialization is done, by this or an earlier call
+ *  @retval false if the function failed in this call
+ */
+template <typename Function>
+bool tryCallOnce(OnceFlag& flag, Function&& function)
+{
+    unsigned int current = flag.state.load(std::memory_order_acquire);
+    while ( current != OnceFlag::DONE )
+    {
+        if ( current != OnceFlag::NEW )
+        {
+            flag.wait();
+            current = flag.state.load(std::memory_order_acquire);
+            continue;
+        }
+        if ( !flag.state.compare_exchange_weak(current, OnceFlag::RUNNING, std::memory_order_acquire) )
+        {
+            continue;
+        }
+        bool done = function();
+        if ( flag.state.exchange(done ? OnceFlag::DONE : OnceFlag::NEW, std::memory_order_acq_rel) == OnceFlag::WAITING )
+        {
+            OnceFlag::waiters().wakeAll(flag.state);
+        }
+        return done;
+    }
+    return true;
+}
+
+/** Runs the function exactly once per flag, even if several threads call it concurrently.
+ *  Threads arriving while the function runs block until it returned; afterwards every call only does a single
+ *  acquire load and the effects of the function are visible to the caller.
+ *  The function must not call callOnce() on the same flag.
+ *  @param[in] flag flag recording the initialization
+ *  @param[in] function function (or lambda) performing the initialization
+ */
+template <typename Function>
+void callOnce(OnceFlag& flag, Function&& function)
+{
+    tryCallOnce(flag, [&function]() { function(); return true; });
+}
+
+#endif // OSAPI_ONCE_H
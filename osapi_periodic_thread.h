@@ -0,0 +1,132 @@
+#ifndef OSAPI_PERIODIC_THREAD_H
+#define OSAPI_PERIODIC_THREAD_H
+
+/** Timing statistics of a periodic thread, all times in nanoseconds (see monotonicNanos()). */
+struct PeriodicStatistics
+{
+    /** number of completed loop() calls */
+    unsigned long cycles;
+    /** number of loop() calls which finished after the next deadline */
+    unsigned long overruns;
+    /** delay of the loop() start with respect to the ideal release time */
+    unsigned long long minJitter;
+    unsigned long long averageJitter;
+    unsigned long long maxJitter;
+    /** execution time of loop() in nanoseconds */
+    unsigned long long minExecution;
+    unsigned long long averageExecution;
+    unsigned long long maxExecution;
+};
+
+/** Mortal thread which calls loop() at a fixed rate, on absolute deadlines.
+ *  Release times are kept on the monotonicNanos() clock and advance by the period regardless of how long
+ *  loop() takes, so the rate does not drift. A loop() that overruns its deadline is followed by the next call
+ *  immediately. The thread waits for the next release in waitForKill(), so kill() ends the wait right away.
+ *  The wait is on the absolute release time: a futex with a CLOCK_MONOTONIC deadline on Linux, the release tick
+ *  itself on FreeRTOS/RTX (like vTaskDelayUntil() and osDelayUntil()), milliseconds on Windows.
+ *  Jitter, execution time and overruns are recorded and can be queried at runtime.
+ */
+class PeriodicThread : public BasicMortalThread<PeriodicThread>
+{
+	friend class BasicMortalThread<PeriodicThread>;
+
+	private:
+		unsigned int perioD;
+		InternalLock statisticsLock;
+		PeriodicStatistics statistics;
+		unsigned long long jitterSum;
+		unsigned long long executionSum;
+
+		void record(unsigned long long jitter, unsigned long long execution, bool overrun)
+		{
+			statisticsLock.lock();
+			if ( statistics.cycles == 0UL || jitter < statistics.minJitter ) statistics.minJitter = jitter;
+			if ( jitter > statistics.maxJitter ) statistics.maxJitter = jitter;
+			if ( statistics.cycles == 0UL || execution < statistics.minExecution ) statistics.minExecution = execution;
+			if ( execution > statistics.maxExecution ) statistics.maxExecution = execution;
+			if ( overrun ) statistics.overruns++;
+			statistics.cycles++;
+			jitterSum += jitter;
+			executionSum += execution;
+			statistics.averageJitter = jitterSum / statistics.cycles;
+			statistics.averageExecution = executionSum / statistics.cycles;
+			statisticsLock.unlock();
+		}
+
+		/** Replaces the free running loop of BasicMortalThread. */
+		void mainLoop()
+		{
+			unsigned long long periodNanos = ticksToNanos(perioD);
+			unsigned long long release = monotonicNanos();
+			while ( !isKilled() )
+			{
+				unsigned long long startNanos = monotonicNanos();
+				loop();
+				quiescentPoint();
+				unsigned long long finishNanos = monotonicNanos();
+				// with OSAPI_USE_DWT a tick based release may be seen a few cycles early
+				unsigned long long jitter = startNanos > release ? startNanos - release : 0ULL;
+				record(jitter, finishNanos - startNanos, finishNanos > release + periodNanos);
+				release += periodNanos;
+				waitForKill(Deadline::atNanos(release));
+			}
+		}
+
+	public:
+		/** Periodic thread constructor.
+		 *  @param[in] priority thread priority
+		 *  @param[in] stackSize thread stack size in bytes
+		 *  @param[in] period number of system ticks between the starts of two consecutive loop() calls
+		 *  @param[in] name optional thread name
+		 */
+		PeriodicThread(int priority, unsigned int stackSize, unsigned int period, const char* name = "unnamed")
+			: BasicMortalThread<PeriodicThread>(priority, stackSize, name), perioD(period)
+		{
+			resetStatistics();
+		}
+
+		/** Periodic thread constructor taking a portable priority level, mapped with nativePriority(). */
+		PeriodicThread(Priority priority, unsigned int stackSize, unsigned int period, const char* name = "unnamed")
+			: PeriodicThread(nativePriority(priority), stackSize, period, name)
+		{
+		}
+
+		virtual ~PeriodicThread() {}
+
+		/** Gets the period.
+		 *  @return number of system ticks between the starts of two consecutive loop() calls
+		 */
+		unsigned int getPeriod()
+		{
+			return perioD;
+		}
+
+		/** Gets a consistent copy of the timing statistics.
+		 *  @return timing statistics collected since the start or since the last resetStatistics()
+		 */
+		PeriodicStatistics getStatistics()
+		{
+			statisticsLock.lock();
+			PeriodicStatistics copy = statistics;
+			statisticsLock.unlock();
+			return copy;
+		}
+
+		/** Clears the timing statistics. */
+		void resetStatistics()
+		{
+			statisticsLock.lock();
+			memset(&statistics, 0, sizeof(statistics));
+			jitterSum = 0ULL;
+			executionSum = 0ULL;
+			statisticsLock.unlock();
+		}
+
+	protected:
+		virtual void begin(void) = 0;
+		virtual void loop(void) = 0;
+		virtual void end(void) = 0;
+
+};
+
+#endif // OSAPI_PERIODIC_THREAD_H
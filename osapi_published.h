@@ -0,0 +1,363 @@
+#ifndef OSAPI_PUBLISHED_H
+#define OSAPI_PUBLISHED_H
+
+class PublishedReader;
+
+/** Global epoch and list of all PublishedReader objects, shared by every Published value.
+ *  Epochs are odd and advance by two with each publish(), so 0 can mark a reader that holds nothing;
+ *  they are compared by their distance, which keeps working when the counter wraps around.
+ *  The list is guarded by an InternalLock; only writers and reader registration take it.
+ */
+class PublishedRegistry : public Registry<PublishedReader>
+{
+private:
+    friend class StaticInstance<PublishedRegistry>;
+
+    alignas(OSAPI_CACHE_LINE_SIZE) std::atomic<unsigned int> epoch;
+
+    PublishedRegistry() : epoch(1U)
+    {
+    }
+
+public:
+    /** Gets the registry. It is created on first use and never destroyed.
+     *  @return the global registry
+     */
+    static PublishedRegistry& instance()
+    {
+        return StaticInstance<PublishedRegistry>::get();
+    }
+
+    /** Gets the current epoch.
+     *  @return current epoch (odd)
+     */
+    unsigned int current() const
+    {
+        return epoch.load();
+    }
+
+    /** Starts a new epoch, called after a new version was published.
+     *  @return the new epoch, readers which announced it do not hold any version replaced before
+     */
+    unsigned int advance()
+    {
+        return epoch.fetch_add(2U) + 2U;
+    }
+
+    inline unsigned int maxLag(unsigned int now);
+};
+
+/** Read side of Published values for one thread. Each thread reading Published values owns one reader
+ *  (it may be used for any number of Published objects) and only that thread calls its methods.
+ *  The reader announces the epoch it last observed in a slot on its own cache line; readers never write
+ *  shared memory, so they do not slow down each other.
+ *  A reader is either used with short read guards (Published::read(), it holds nothing between guards),
+ *  or it goes online() and calls quiescent() at points where it holds no version, e.g. between two loop()
+ *  calls of a mortal thread (see BasicMortalThread::setPublishedReader()). Guards of an online reader
+ *  cost no store at all. A version is reclaimed once all readers passed a quiescent point or left their guards.
+ */
+class PublishedReader
+{
+private:
+    friend class PublishedRegistry;
+    template <typename Entry>
+    friend class Registry;
+
+    /** epoch announced by the reader, 0 if it holds no version */
+    alignas(OSAPI_CACHE_LINE_SIZE) std::atomic<unsigned int> seen;
+    unsigned int depth;
+    bool onlinE;
+    PublishedReader* next;
+    PublishedReader** link;
+
+    /** Announces the current epoch: versions replaced before it are not used by this thread any more. */
+    void announce()
+    {
+        unsigned int now = PublishedRegistry::instance().current();
+        if ( seen.load(std::memory_order_relaxed) != now )
+        {
+            // sequentially consistent, so the version loaded next can't be older than the announced epoch
+            seen.store(now);
+        }
+    }
+
+public:
+    /** Creates an offline reader and registers it. */
+    PublishedReader() : seen(0U), depth(0U), onlinE(false), next(nullptr), link(nullptr)
+    {
+        PublishedRegistry::instance().add(*this);
+    }
+
+    /** Unregisters the reader, it must not hold any read guard. */
+    ~PublishedReader()
+    {
+        PublishedRegistry::instance().remove(*this);
+    }
+
+    PublishedReader(const PublishedReader&) = delete;
+    PublishedReader& operator=(const PublishedReader&) = delete;
+
+    /** Marks the start of a read guard. */
+    void enter()
+    {
+        if ( depth++ == 0U && !onlinE )
+        {
+            announce();
+        }
+    }
+
+    /** Marks the end of a read guard. */
+    void leave()
+    {
+        if ( --depth == 0U && !onlinE )
+        {
+            seen.store(0U, std::memory_order_release);
+        }
+    }
+
+    /** Keeps the reader online: versions read stay valid until the next quiescent() or offline() call,
+     *  and writers wait for that call before reclaiming them.
+     */
+    void online()
+    {
+        onlinE = true;
+        announce();
+    }
+
+    /** Tells the writers that the thread holds no version read before this call.
+     *  Costs a load of the global epoch, plus a store to the reader's own slot if a new version was published.
+     *  Does nothing while a read guard is alive.
+     */
+    void quiescent()
+    {
+        if ( depth == 0U )
+        {
+            announce();
+        }
+    }
+
+    /** Takes the reader offline, e.g. before a long wait, so it does not hold up reclamation. */
+    void offline()
+    {
+        onlinE = false;
+        if ( depth == 0U )
+        {
+            seen.store(0U, std::memory_order_release);
+        }
+    }
+
+    /** Checks if the reader is online.
+     *  @retval true if online() was called last
+     *  @retval false otherwise
+     */
+    bool isOnline() const
+    {
+        return onlinE;
+    }
+};
+
+/** Finds the reader lagging most behind.
+ *  @param[in] now current epoch
+ *  @return largest distance between now and the epoch announced by a reader, 0 if no reader holds a version
+ */
+inline unsigned int PublishedRegistry::maxLag(unsigned int now)
+{
+    unsigned int lag = 0U;
+    forEach([&](PublishedReader& reader) -> bool {
+        unsigned int seen = reader.seen.load();
+        if ( seen != 0U && now - seen > lag )
+        {
+            lag = now - seen;
+        }
+        return true;
+    });
+    return lag;
+}
+
+/** Value shared by many readers and replaced as a whole by writers (read-copy-update).
+ *  publish() builds a new immutable version and swaps it in with one atomic pointer exchange;
+ *  readers keep using the version they got until they are done with it, the old version is deleted
+ *  once every PublishedReader passed a quiescent point. Readers take no lock and write no shared memory,
+ *  writers never wait for readers: versions still in use stay on a retire list and are reclaimed
+ *  by a later publish() or reclaim().
+ *  Suited for large, read-mostly data such as configuration; versions are allocated with new.
+ *  @tparam T type of the value, constructible from the arguments passed to publish()
+ */
+template <typename T>
+class Published
+{
+private:
+    struct Version
+    {
+        T value;
+        unsigned int retired;
+        Version* next;
+
+        template <typename... Args>
+        explicit Version(Args&&... args) : value(std::forward<Args>(args)...), retired(0U), next(nullptr)
+        {
+        }
+    };
+
+    std::atomic<Version*> current;
+    InternalLock writeLock;
+    Version* retiredList;
+
+    /** Deletes the retired versions no reader can hold any more, called with writeLock held.
+     *  @return number of versions still waiting for readers
+     */
+    unsigned int reclaimLocked()
+    {
+        if ( retiredList == nullptr )
+        {
+            return 0U;
+        }
+        PublishedRegistry& registry = PublishedRegistry::instance();
+        unsigned int now = registry.current();
+        unsigned int lag = registry.maxLag(now);
+        unsigned int pending = 0U;
+        Version** link = &retiredList;
+        while ( *link != nullptr )
+        {
+            Version* version = *link;
+            // every reader announced an epoch at or after the one the version was replaced in
+            if ( now - version->retired >= lag )
+            {
+                *link = version->next;
+                delete version;
+            }
+            else
+            {
+                link = &version->next;
+                pending++;
+            }
+        }
+        return pending;
+    }
+
+public:
+    /** Read access to one version, valid while the guard lives. Movable, not copyable. */
+    class Guard
+    {
+    private:
+        const T* value;
+        PublishedReader* reader;
+
+    public:
+        Guard(const T* value, PublishedReader& reader) : value(value), reader(&reader)
+        {
+        }
+
+        Guard(Guard&& other) : value(other.value), reader(other.reader)
+        {
+            other.reader = nullptr;
+        }
+
+        ~Guard()
+        {
+            if ( reader != nullptr )
+            {
+                reader->leave();
+            }
+        }
+
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+        Guard& operator=(Guard&&) = delete;
+
+        /** Gets the version.
+         *  @return the version, nullptr if nothing was published yet
+         */
+        const T* get() const
+        {
+            return value;
+        }
+
+        const T& operator*() const
+        {
+            return *value;
+        }
+
+        const T* operator->() const
+        {
+            return value;
+        }
+
+        explicit operator bool() const
+        {
+            return value != nullptr;
+        }
+    };
+
+    /** Creates the object without a version, readers get nullptr until the first publish(). */
+    Published() : current(nullptr), retiredList(nullptr)
+    {
+    }
+
+    /** Deletes all versions, no reader may use them any more. */
+    ~Published()
+    {
+        delete current.load();
+        while ( retiredList != nullptr )
+        {
+            Version* version = retiredList;
+            retiredList = version->next;
+            delete version;
+        }
+    }
+
+    Published(const Published&) = delete;
+    Published& operator=(const Published&) = delete;
+
+    /** Builds a new version from the arguments and makes it the current one.
+     *  Never waits for readers; deletes the older versions that are no longer in use.
+     *  @param[in] args arguments for the constructor of T
+     *  @retval true if the new version was published
+     *  @retval false if it could not be allocated
+     */
+    template <typename... Args>
+    bool publish(Args&&... args)
+    {
+        Version* version = new (std::nothrow) Version(std::forward<Args>(args)...);
+        if ( version == nullptr )
+        {
+            return false;
+        }
+        writeLock.lock();
+        Version* old = current.exchange(version);
+        if ( old != nullptr )
+        {
+            old->retired = PublishedRegistry::instance().advance();
+            old->next = retiredList;
+            retiredList = old;
+        }
+        reclaimLocked();
+        writeLock.unlock();
+        return true;
+    }
+
+    /** Gets the current version for the calling thread.
+     *  @param[in] reader reader of the calling thread
+     *  @return guard giving access to the version (nullptr if nothing was published yet)
+     */
+    Guard read(PublishedReader& reader) const
+    {
+        reader.enter();
+        Version* version = current.load();
+        return Guard(version != nullptr ? &version->value : nullptr, reader);
+    }
+
+    /** Deletes the retired versions no reader holds any more. publish() does it as well,
+     *  call it to release memory when no new version follows for a while.
+     *  @return number of versions still in use by lagging readers
+     */
+    unsigned int reclaim()
+    {
+        writeLock.lock();
+        unsigned int pending = reclaimLocked();
+        writeLock.unlock();
+        return pending;
+    }
+};
+
+#endif // OSAPI_PUBLISHED_H
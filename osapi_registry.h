@@ -0,0 +1,161 @@
+#ifndef OSAPI_REGISTRY_H
+#define OSAPI_REGISTRY_H
+
+/** Lock guarding the library's own bookkeeping (the registries, the writers of Published), built on WaitQueue.
+ *  It is no Mutex on purpose: it never shows up in the MutexRegistry (OSAPI_MUTEX_PROFILING) and can be
+ *  taken while the MutexRegistry itself is updated. The mutexes composed of other locks (AdaptiveMutex,
+ *  SharedMutex, RecursiveMutex on Linux), ThreadPool and TimerService use it inside as well, so only the mutexes
+ *  of the application are profiled.
+ *  The uncontended lock() and unlock() are a single atomic operation each.
+ */
+class InternalLock
+{
+private:
+    /** 0 - unlocked, 1 - locked, 2 - locked and other threads may be waiting */
+    std::atomic<unsigned int> state;
+    WaitQueue released;
+
+public:
+    InternalLock() : state(0U)
+    {
+    }
+
+    InternalLock(const InternalLock&) = delete;
+    InternalLock& operator=(const InternalLock&) = delete;
+
+    void lock()
+    {
+        lock(UINT_MAX);
+    }
+
+    /** Locks, blocking the calling thread for the maximum given timeout while the lock is taken.
+     *  @param[in] timeout maximum number of milliseconds to block the calling thread
+     *  @retval true if the lock was taken
+     *  @retval false if the lock was not taken within the given time
+     */
+    bool lock(unsigned int timeout)
+    {
+        unsigned int expected = 0U;
+        if ( state.compare_exchange_strong(expected, 1U, std::memory_order_acquire, std::memory_order_relaxed) )
+        {
+            return true;
+        }
+        if ( timeout == 0U )
+        {
+            return false;
+        }
+        Deadline left(timeout);
+        // mark the lock as contended, so that the owner wakes us up on unlock
+        while ( state.exchange(2U, std::memory_order_acquire) != 0U )
+        {
+            unsigned int remaining = left.remaining();
+            if ( remaining == 0U )
+            {
+                return false;
+            }
+            released.wait(state, 2U, remaining);
+        }
+        return true;
+    }
+
+    void unlock()
+    {
+        if ( state.exchange(0U, std::memory_order_release) == 2U )
+        {
+            released.wakeOne(state);
+        }
+    }
+};
+
+/** Intrusive list of entries guarded by an InternalLock, the common part of the global registries.
+ *  Entries keep the links themselves (Entry* next, Entry** link pointing to the field referencing the entry,
+ *  nullptr while not registered) and make Registry a friend, so adding and removing never allocates.
+ *  @tparam Entry type of the entries
+ */
+template <typename Entry>
+class Registry
+{
+private:
+    InternalLock guard;
+    Entry* head;
+    unsigned int count;
+
+protected:
+    Registry() : head(nullptr), count(0U)
+    {
+    }
+
+    /** Calls the visitor for every entry with the registry locked, entries can't leave meanwhile.
+     *  @param[in] visitor callable taking an Entry&, returns false to stop
+     */
+    template <typename Visitor>
+    void forEach(Visitor visitor)
+    {
+        guard.lock();
+        for ( Entry* entry = head; entry != nullptr && visitor(*entry); entry = entry->next )
+        {
+        }
+        guard.unlock();
+    }
+
+public:
+    Registry(const Registry&) = delete;
+    Registry& operator=(const Registry&) = delete;
+
+    /** Adds an entry to the registry.
+     *  @param[in] entry entry to add
+     *  @retval true if the entry was added
+     *  @retval false if the entry was already registered
+     */
+    bool add(Entry& entry)
+    {
+        bool added = false;
+        guard.lock();
+        if ( entry.link == nullptr )
+        {
+            entry.next = head;
+            if ( head != nullptr )
+            {
+                head->link = &entry.next;
+            }
+            head = &entry;
+            entry.link = &head;
+            count++;
+            added = true;
+        }
+        guard.unlock();
+        return added;
+    }
+
+    /** Removes an entry from the registry, does nothing if it is not registered.
+     *  @param[in] entry entry to remove
+     */
+    void remove(Entry& entry)
+    {
+        guard.lock();
+        if ( entry.link != nullptr )
+        {
+            *entry.link = entry.next;
+            if ( entry.next != nullptr )
+            {
+                entry.next->link = entry.link;
+            }
+            entry.link = nullptr;
+            count--;
+        }
+        guard.unlock();
+    }
+
+    /** Gets the number of registered entries.
+     *  @return number of entries
+     */
+    unsigned int getCount()
+    {
+        guard.lock();
+        unsigned int current = count;
+        guard.unlock();
+        return current;
+    }
+};
+
+#endif // OSAPI_REGISTRY_H
@@ -0,0 +1,133 @@
+#ifndef OSAPI_SEQ_LOCK_H
+#define OSAPI_SEQ_LOCK_H
+
+/** Sequence lock publishing a value from a single writer to any number of readers.
+ *  The writer never blocks: it makes the sequence number odd, stores the value and makes it even again.
+ *  Readers copy the value and retry if the sequence number was odd or changed meanwhile, so they never write
+ *  to shared memory and do not slow down each other or the writer. Suited for small, frequently updated
+ *  snapshots (telemetry, sensor state) where readers only need the latest consistent value.
+ *  The value is kept in atomic words, so the concurrent copies are not data races.
+ *  Only one thread may write at a time; several writers have to be serialized by the caller.
+ *  On a single core, a reader that spins in read() while preempting the writer in the middle of write() never
+ *  finishes. Readers with a higher priority than the writer should use tryRead() and retry later instead.
+ *  @tparam T type of the value, has to be trivially copyable and default constructible
+ */
+template <typename T>
+class SeqLock
+{
+    static_assert(std::is_trivially_copyable<T>::value, "SeqLock value has to be trivially copyable");
+
+private:
+    static const unsigned int WORDS = (sizeof(T) + sizeof(uintptr_t) - 1U) / sizeof(uintptr_t);
+
+    alignas(OSAPI_CACHE_LINE_SIZE) std::atomic<unsigned int> sequence;
+    std::atomic<uintptr_t> words[WORDS];
+
+    /** Copies the value once.
+     *  @param[out] value receives the copy
+     *  @retval true if the copy is consistent
+     *  @retval false if the writer was active, the copy has to be discarded
+     */
+    bool copy(T& value) const
+    {
+        unsigned int before = sequence.load(std::memory_order_acquire);
+        if ( ( before & 1U ) != 0U )
+        {
+            return false;
+        }
+        uintptr_t buffer[WORDS];
+        for ( unsigned int i = 0U; i < WORDS; i++ )
+        {
+            buffer[i] = words[i].load(std::memory_order_relaxed);
+        }
+        // keeps the word loads above from moving below the second sequence load
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if ( sequence.load(std::memory_order_relaxed) != before )
+        {
+            return false;
+        }
+        memcpy(&value, buffer, sizeof(T));
+        return true;
+    }
+
+public:
+    /** Creates the lock holding a value with all bytes zero. */
+    SeqLock() : sequence(0U)
+    {
+        for ( unsigned int i = 0U; i < WORDS; i++ )
+        {
+            words[i].store(0U, std::memory_order_relaxed);
+        }
+    }
+
+    /** Creates the lock holding the given value.
+     *  @param[in] initial initial value
+     */
+    explicit SeqLock(const T& initial) : SeqLock()
+    {
+        write(initial);
+        sequence.store(0U, std::memory_order_relaxed);
+    }
+
+    SeqLock(const SeqLock&) = delete;
+    SeqLock& operator=(const SeqLock&) = delete;
+
+    /** Publishes a new value. Never blocks; only one thread may call it at a time.
+     *  @param[in] value new value
+     */
+    void write(const T& value)
+    {
+        uintptr_t buffer[WORDS];
+        buffer[WORDS - 1U] = 0U;
+        memcpy(buffer, &value, sizeof(T));
+
+        unsigned int current = sequence.load(std::memory_order_relaxed);
+        sequence.store(current + 1U, std::memory_order_relaxed);
+        // keeps the word stores below from moving above the odd sequence number
+        std::atomic_thread_fence(std::memory_order_release);
+        for ( unsigned int i = 0U; i < WORDS; i++ )
+        {
+            words[i].store(buffer[i], std::memory_order_relaxed);
+        }
+        sequence.store(current + 2U, std::memory_order_release);
+    }
+
+    /** Reads the latest value, retrying as long as the writer interferes.
+     *  @return consistent copy of the value
+     */
+    T read() const
+    {
+        T value;
+        while ( !copy(value) )
+        {
+            cpuRelax();
+        }
+        return value;
+    }
+
+    /** Tries to read the latest value once, without waiting for the writer.
+     *  @param[out] value receives the value, unchanged on failure
+     *  @retval true if a consistent value was read
+     *  @retval false if the writer was active, try again later
+     */
+    bool tryRead(T& value) const
+    {
+        T copied;
+        if ( !copy(copied) )
+        {
+            return false;
+        }
+        value = copied;
+        return true;
+    }
+
+    /** Gets the number of completed writes, lets readers skip a read if nothing changed.
+     *  @return number of calls to write() completed so far (wraps around)
+     */
+    unsigned int getVersion() const
+    {
+        return sequence.load(std::memory_order_acquire) >> 1U;
+    }
+};
+
+#endif // OSAPI_SEQ_LOCK_H
@@ -0,0 +1,199 @@
+#ifndef OSAPI_SHARED_MUTEX_H
+#define OSAPI_SHARED_MUTEX_H
+
+#ifndef OSAPI_SHARED_MUTEX_SLOTS
+/** Number of reader counters of a SharedMutex (power of two), each one occupies a cache line. */
+#define OSAPI_SHARED_MUTEX_SLOTS 8U
+#endif
+
+/** Reader-writer mutex: many readers may hold it at the same time, a writer holds it alone.
+ *  Readers are counted on several cache-line sized slots picked by currentThreadIndex(),
+ *  so readers running on different cores don't write to the same cache line. A reader only reads the shared
+ *  writer counter, which stays in every core's cache as long as no writer shows up.
+ *  Writers are preferred: once a writer is waiting, new readers back off until all writers are done,
+ *  so a steady stream of readers can't starve writers (but writers can starve readers).
+ *  lock()/unlock() take the mutex exclusively, so it can be used wherever a MutexInterface is expected.
+ *  The mutex is not recursive, neither for readers nor for writers.
+ */
+class SharedMutex : public BasicMutex<SharedMutex>
+{
+    friend class BasicMutex<SharedMutex>;
+
+    static_assert((OSAPI_SHARED_MUTEX_SLOTS & (OSAPI_SHARED_MUTEX_SLOTS - 1U)) == 0U, "OSAPI_SHARED_MUTEX_SLOTS has to be a power of two");
+
+private:
+    struct alignas(OSAPI_CACHE_LINE_SIZE) ReaderSlot
+    {
+        /** may go negative, when a reader unlocks on another slot than the one it locked on; only the sum counts */
+        std::atomic<int> readers;
+    };
+
+    ReaderSlot slots[OSAPI_SHARED_MUTEX_SLOTS];
+
+    /** number of writers holding or waiting for the mutex */
+    alignas(OSAPI_CACHE_LINE_SIZE) std::atomic<unsigned int> writers;
+
+    alignas(OSAPI_CACHE_LINE_SIZE) InternalLock writerMutex;
+    std::atomic<unsigned int> readersWaiting;
+    std::atomic<unsigned int> writerEvents;
+    WaitQueue writersGone;
+    std::atomic<bool> writerDraining;
+    std::atomic<unsigned int> readerEvents;
+    WaitQueue readersGone;
+
+    /** Picks the reader slot of the calling thread. */
+    static unsigned int slotIndex()
+    {
+        return currentThreadIndex() & (OSAPI_SHARED_MUTEX_SLOTS - 1U);
+    }
+
+    int readerCount()
+    {
+        int count = 0;
+        for ( unsigned int i = 0U; i < OSAPI_SHARED_MUTEX_SLOTS; i++ )
+        {
+            count += slots[i].readers.load();
+        }
+        return count;
+    }
+
+    /** Wakes up the writer waiting for the readers to leave, when the last one is gone. */
+    void readerLeft()
+    {
+        if ( writerDraining.load() && readerCount() == 0 )
+        {
+            readerEvents.fetch_add(1U);
+            readersGone.wakeOne(readerEvents);
+        }
+    }
+
+    /** Drops the writer counter and lets the readers in, if it was the last writer. */
+    void writerLeft()
+    {
+        if ( writers.fetch_sub(1U) == 1U && readersWaiting.load() != 0U )
+        {
+            writerEvents.fetch_add(1U);
+            writersGone.wakeAll(writerEvents);
+        }
+    }
+
+public:
+    SharedMutex() : writers(0U), readersWaiting(0U), writerEvents(0U), writerDraining(false), readerEvents(0U)
+    {
+        for ( unsigned int i = 0U; i < OSAPI_SHARED_MUTEX_SLOTS; i++ )
+        {
+            slots[i].readers.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    /** Locks the mutex for reading. The calling thread blocks while a writer holds or waits for the mutex,
+     *  for the maximum given timeout.
+     *  @param[in] timeout maximum number of milliseconds allowed to block the calling thread
+     *  @retval true if the mutex was locked for reading
+     *  @retval false if the mutex was not locked within the given time
+     */
+    bool lockShared(unsigned int timeout)
+    {
+        std::atomic<int>& readers = slots[slotIndex()].readers;
+        // pairs with the writer, which announces itself before counting the readers
+        readers.fetch_add(1);
+        if ( writers.load() == 0U )
+        {
+            return true;
+        }
+
+        Deadline left(timeout);
+        while ( true )
+        {
+            readers.fetch_sub(1);
+            readerLeft();
+
+            unsigned int remaining = left.remaining();
+            if ( remaining == 0U )
+            {
+                return false;
+            }
+            unsigned int seen = writerEvents.load();
+            readersWaiting.fetch_add(1U);
+            if ( writers.load() != 0U )
+            {
+                writersGone.wait(writerEvents, seen, remaining);
+            }
+            readersWaiting.fetch_sub(1U);
+
+            readers.fetch_add(1);
+            if ( writers.load() == 0U )
+            {
+                return true;
+            }
+        }
+    }
+
+    /** Locks the mutex for reading, blocking the calling thread at most until the given deadline.
+     *  @param[in] deadline point in time after which the calling thread stops waiting
+     *  @retval true if the mutex was locked for reading
+     *  @retval false if the mutex was not locked before the deadline
+     */
+    bool lockShared(const Deadline& deadline)
+    {
+        return lockShared(deadline.remaining());
+    }
+
+    /** Unlocks the mutex locked for reading. */
+    void unlockShared()
+    {
+        slots[slotIndex()].readers.fetch_sub(1);
+        if ( writers.load() != 0U )
+        {
+            readerLeft();
+        }
+    }
+
+private:
+
+    /** Locks the mutex for writing. Blocks new readers, then waits until the current readers are gone.
+     *  @param[in] timeout maximum number of milliseconds allowed to block the calling thread
+     *  @retval true if the mutex was locked for writing
+     *  @retval false if the mutex was not locked within the given time
+     */
+    bool lockImpl(unsigned int timeout)
+    {
+        Deadline left(timeout);
+        writers.fetch_add(1U);
+        if ( !writerMutex.lock(timeout) )
+        {
+            writerLeft();
+            return false;
+        }
+
+        writerDraining.store(true);
+        while ( readerCount() != 0 )
+        {
+            unsigned int remaining = left.remaining();
+            if ( remaining == 0U )
+            {
+                writerDraining.store(false);
+                writerMutex.unlock();
+                writerLeft();
+                return false;
+            }
+            unsigned int seen = readerEvents.load();
+            if ( readerCount() != 0 )
+            {
+                readersGone.wait(readerEvents, seen, remaining);
+            }
+        }
+        return true;
+    }
+
+    /** Unlocks the mutex locked for writing. */
+    void unlockImpl()
+    {
+        writerDraining.store(false);
+        writerMutex.unlock();
+        writerLeft();
+    }
+
+};
+
+#endif // OSAPI_SHARED_MUTEX_H
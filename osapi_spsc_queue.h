@@ -0,0 +1,234 @@
+#ifndef OSAPI_SPSC_QUEUE_H
+#define OSAPI_SPSC_QUEUE_H
+
+/** Lock-free single-producer, single-consumer queue with a fixed capacity.
+ *  Exactly one thread may push and exactly one thread may pop. tryPush()/tryPop() are wait-free;
+ *  push()/pop() block the calling thread when the queue is full/empty, with the same millisecond
+ *  timeout convention as MutexInterface::lock().
+ *  The producer and the consumer indices live on separate cache lines, and each side keeps
+ *  a private copy of the other side's index, so the shared lines are touched only when needed.
+ *  @tparam T type of the items, has to be default constructible and copy assignable
+ *  @tparam N capacity of the queue, has to be a power of two
+ */
+template <typename T, unsigned int N>
+class SpscQueue
+{
+    static_assert(N != 0U && (N & (N - 1U)) == 0U, "SpscQueue capacity has to be a power of two");
+
+private:
+    // producer side
+    alignas(OSAPI_CACHE_LINE_SIZE) std::atomic<unsigned int> tail;
+    unsigned int cachedHead;
+
+    // consumer side
+    alignas(OSAPI_CACHE_LINE_SIZE) std::atomic<unsigned int> head;
+    unsigned int cachedTail;
+
+    // blocking push() / pop() support, rarely written
+    alignas(OSAPI_CACHE_LINE_SIZE) std::atomic<bool> producerWaiting;
+    std::atomic<bool> consumerWaiting;
+    WaitQueue notFull;
+    WaitQueue notEmpty;
+
+    alignas(OSAPI_CACHE_LINE_SIZE) T buffer[N];
+
+    /** Called by the producer after publishing new items. */
+    void itemsPushed()
+    {
+        if ( consumerWaiting.load() )
+        {
+            notEmpty.wakeOne(tail);
+        }
+    }
+
+    /** Called by the consumer after releasing slots. */
+    void itemsPopped()
+    {
+        if ( producerWaiting.load() )
+        {
+            notFull.wakeOne(head);
+        }
+    }
+
+public:
+    SpscQueue() : tail(0U), cachedHead(0U), head(0U), cachedTail(0U), producerWaiting(false), consumerWaiting(false)
+    {
+    }
+
+    /** Pushes an item, if there is room for it (producer only).
+     *  @param[in] item item to be copied into the queue
+     *  @retval true if the item was pushed
+     *  @retval false if the queue is full
+     */
+    bool tryPush(const T& item)
+    {
+        unsigned int position = tail.load(std::memory_order_relaxed);
+        if ( position - cachedHead == N )
+        {
+            cachedHead = head.load(std::memory_order_acquire);
+            if ( position - cachedHead == N )
+            {
+                return false;
+            }
+        }
+        buffer[position & (N - 1U)] = item;
+        tail.store(position + 1U);
+        itemsPushed();
+        return true;
+    }
+
+    /** Pops an item, if there is any (consumer only).
+     *  @param[out] item storage for the popped item
+     *  @retval true if an item was popped
+     *  @retval false if the queue is empty
+     */
+    bool tryPop(T& item)
+    {
+        unsigned int position = head.load(std::memory_order_relaxed);
+        if ( position == cachedTail )
+        {
+            cachedTail = tail.load(std::memory_order_acquire);
+            if ( position == cachedTail )
+            {
+                return false;
+            }
+        }
+        item = buffer[position & (N - 1U)];
+        head.store(position + 1U);
+        itemsPopped();
+        return true;
+    }
+
+    /** Pushes as many of the given items as there is room for, publishing them at once (producer only).
+     *  @param[in] items items to be copied into the queue
+     *  @param[in] count number of items
+     *  @return number of items pushed
+     */
+    unsigned int pushN(const T* items, unsigned int count)
+    {
+        unsigned int position = tail.load(std::memory_order_relaxed);
+        if ( N - (position - cachedHead) < count )
+        {
+            cachedHead = head.load(std::memory_order_acquire);
+        }
+        unsigned int room = N - (position - cachedHead);
+        if ( count > room )
+        {
+            count = room;
+        }
+        if ( count == 0U )
+        {
+            return 0U;
+        }
+        for ( unsigned int i = 0U; i < count; i++ )
+        {
+            buffer[(position + i) & (N - 1U)] = items[i];
+        }
+        tail.store(position + count);
+        itemsPushed();
+        return count;
+    }
+
+    /** Pops up to the given number of items, releasing their slots at once (consumer only).
+     *  @param[out] items storage for the popped items
+     *  @param[in] count maximum number of items to pop
+     *  @return number of items popped
+     */
+    unsigned int popN(T* items, unsigned int count)
+    {
+        unsigned int position = head.load(std::memory_order_relaxed);
+        if ( cachedTail - position < count )
+        {
+            cachedTail = tail.load(std::memory_order_acquire);
+        }
+        unsigned int available = cachedTail - position;
+        if ( count > available )
+        {
+            count = available;
+        }
+        if ( count == 0U )
+        {
+            return 0U;
+        }
+        for ( unsigned int i = 0U; i < count; i++ )
+        {
+            items[i] = buffer[(position + i) & (N - 1U)];
+        }
+        head.store(position + count);
+        itemsPopped();
+        return count;
+    }
+
+    /** Pushes an item, blocking the producer while the queue is full, for the maximum given timeout.
+     *  @param[in] item item to be copied into the queue
+     *  @param[in] timeout maximum number of milliseconds to wait for a free slot
+     *  @retval true if the item was pushed
+     *  @retval false if the queue stayed full within the given time
+     */
+    bool push(const T& item, unsigned int timeout)
+    {
+        Deadline left(timeout);
+        while ( !tryPush(item) )
+        {
+            unsigned int remaining = left.remaining();
+            if ( remaining == 0U )
+            {
+                return false;
+            }
+            unsigned int position = head.load(std::memory_order_relaxed);
+            producerWaiting.store(true);
+            if ( tail.load(std::memory_order_relaxed) - head.load() == N )
+            {
+                notFull.wait(head, position, remaining);
+            }
+            producerWaiting.store(false, std::memory_order_relaxed);
+        }
+        return true;
+    }
+
+    /** Pops an item, blocking the consumer while the queue is empty, for the maximum given timeout.
+     *  @param[out] item storage for the popped item
+     *  @param[in] timeout maximum number of milliseconds to wait for an item
+     *  @retval true if an item was popped
+     *  @retval false if the queue stayed empty within the given time
+     */
+    bool pop(T& item, unsigned int timeout)
+    {
+        Deadline left(timeout);
+        while ( !tryPop(item) )
+        {
+            unsigned int remaining = left.remaining();
+            if ( remaining == 0U )
+            {
+                return false;
+            }
+            unsigned int position = tail.load(std::memory_order_relaxed);
+            consumerWaiting.store(true);
+            if ( head.load(std::memory_order_relaxed) == tail.load() )
+            {
+                notEmpty.wait(tail, position, remaining);
+            }
+            consumerWaiting.store(false, std::memory_order_relaxed);
+        }
+        return true;
+    }
+
+    /** Gets the number of items in the queue (approximate when called concurrently).
+     *  @return number of items in the queue
+     */
+    unsigned int size()
+    {
+        return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+    }
+
+    /** Gets the capacity of the queue.
+     *  @return maximum number of items the queue can hold
+     */
+    unsigned int capacity()
+    {
+        return N;
+    }
+
+};
+
+#endif // OSAPI_SPSC_QUEUE_H
@@ -0,0 +1,71 @@
+#ifndef OSAPI_STATIC_INSTANCE_H
+#define OSAPI_STATIC_INSTANCE_H
+
+/** Global object created on first use and never destroyed, so objects with static storage duration can use it
+ *  in any order of construction and destruction.
+ *  Does not rely on thread-safe initialization of function-local statics, which embedded builds often turn off
+ *  (-fno-threadsafe-statics): the state is constant-initialized, concurrent first callers each construct a
+ *  candidate and one of them is published with a CAS, the others are destroyed again. The first candidate is
+ *  built in static storage, only the losers of a concurrent creation allocate theirs from the heap.
+ *  @tparam T type of the object, default constructible (make StaticInstance a friend for a private constructor)
+ *  @tparam Tag distinguishes several instances of the same type
+ */
+template <typename T, typename Tag = T>
+class StaticInstance
+{
+private:
+    static std::atomic<T*> instance;
+    static std::atomic<bool> storageTaken;
+    alignas(T) static unsigned char storage[sizeof(T)];
+
+    static T* create()
+    {
+        bool inStorage = !storageTaken.exchange(true);
+        T* candidate = inStorage ? new (storage) T() : new (std::nothrow) T();
+        if ( candidate == nullptr )
+        {
+            // out of memory, the thread which took the storage publishes its object shortly
+            T* published;
+            while ( ( published = instance.load(std::memory_order_acquire) ) == nullptr )
+            {
+                cpuRelax();
+            }
+            return published;
+        }
+        T* expected = nullptr;
+        if ( instance.compare_exchange_strong(expected, candidate, std::memory_order_acq_rel, std::memory_order_acquire) )
+        {
+            return candidate;
+        }
+        if ( inStorage )
+        {
+            candidate->~T();
+        }
+        else
+        {
+            delete candidate;
+        }
+        return expected;
+    }
+
+public:
+    /** Gets the object, creates it on the first call.
+     *  @return the global object
+     */
+    static T& get()
+    {
+        T* current = instance.load(std::memory_order_acquire);
+        return current != nullptr ? *current : *create();
+    }
+};
+
+template <typename T, typename Tag>
+std::atomic<T*> StaticInstance<T, Tag>::instance(nullptr);
+
+template <typename T, typename Tag>
+std::atomic<bool> StaticInstance<T, Tag>::storageTaken(false);
+
+template <typename T, typename Tag>
+alignas(T) unsigned char StaticInstance<T, Tag>::storage[sizeof(T)];
+
+#endif // OSAPI_STATIC_INSTANCE_H
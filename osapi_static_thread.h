@@ -0,0 +1,42 @@
+#ifndef OSAPI_STATIC_THREAD_H
+#define OSAPI_STATIC_THREAD_H
+
+/** Thread carrying its own stack and control block, so run() does not allocate anything
+ *  and the memory footprint is known at link time (xTaskCreateStatic() on FreeRTOS,
+ *  stack_mem/cb_mem on RTX, pthread_attr_setstack() on Linux; Windows always uses its own memory).
+ *  @tparam StackBytes size of the thread stack in bytes, on Linux at least PTHREAD_STACK_MIN (16 KiB on x86-64,
+ *                    128 KiB on aarch64; OSAPI_STATIC_THREAD_MIN_STACK is checked at compile time, run() fails below)
+ */
+template <unsigned int StackBytes>
+class StaticThread : public Thread
+{
+    static_assert(StackBytes % 8U == 0U, "StaticThread stack size has to be a multiple of 8 bytes");
+#ifdef OSAPI_STATIC_THREAD_MIN_STACK
+    static_assert(StackBytes >= OSAPI_STATIC_THREAD_MIN_STACK, "StaticThread stack is smaller than the system minimum");
+#endif
+
+    private:
+        alignas(16) unsigned char stackMemory[StackBytes];
+        ThreadControlBlock controlBlock;
+
+    public:
+        /** Static thread constructor.
+         *  @param[in] priority thread priority
+         *  @param[in] isJoinable decides if the thread supports join operation or not
+         *  @param[in] name optional thread name
+         */
+        StaticThread(int priority, Joinable isJoinable, const char* name = "unnamed")
+            : Thread(priority, StackBytes, isJoinable, stackMemory, &controlBlock, name)
+        {
+        }
+
+        /** Static thread constructor taking a portable priority level, mapped with nativePriority(). */
+        StaticThread(Priority priority, Joinable isJoinable, const char* name = "unnamed")
+            : StaticThread(nativePriority(priority), isJoinable, name)
+        {
+        }
+
+        virtual ~StaticThread() {}
+};
+
+#endif // OSAPI_STATIC_THREAD_H
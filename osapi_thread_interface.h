@@ -7,6 +7,53 @@ typedef enum {
     JOINABLE = 1
 } Joinable;
 
+/** Portable thread priority levels, mapped to the native priority of the backend by nativePriority().
+ *  Windows uses the matching THREAD_PRIORITY_* values and RTX the matching osPriority_t values.
+ *  FreeRTOS spreads the levels over configMAX_PRIORITIES (PRIORITY_IDLE is tskIDLE_PRIORITY).
+ *  Linux runs PRIORITY_IDLE with SCHED_IDLE, PRIORITY_LOW to PRIORITY_NORMAL with SCHED_OTHER and the levels above
+ *  with the real-time policy OSAPI_REALTIME_POLICY (SCHED_FIFO by default), which requires CAP_SYS_NICE.
+ */
+typedef enum {
+    PRIORITY_IDLE = 0,
+    PRIORITY_LOW = 1,
+    PRIORITY_BELOW_NORMAL = 2,
+    PRIORITY_NORMAL = 3,
+    PRIORITY_ABOVE_NORMAL = 4,
+    PRIORITY_HIGH = 5,
+    PRIORITY_REALTIME = 6
+} Priority;
+
+/** Converts a portable priority level into the priority value of the backend, as taken by the Thread constructors.
+ *  @param[in] priority portable priority level
+ *  @return native priority
+ */
+inline int nativePriority(Priority priority);
+
+/** Thread creation parameters, an alternative to the positional Thread constructor arguments. */
+struct ThreadAttributes
+{
+    /** thread priority */
+    int priority;
+    /** thread stack size in bytes */
+    unsigned int stackSize;
+    /** decides if the thread supports join operation or not */
+    Joinable joinable;
+    /** thread name */
+    const char* name;
+    /** cores the thread may run on, applied before the thread starts */
+    AffinityMask affinity;
+
+    ThreadAttributes(int priority, unsigned int stackSize, Joinable joinable = JOINABLE, const char* name = "unnamed", AffinityMask affinity = ANY_CPU)
+        : priority(priority), stackSize(stackSize), joinable(joinable), name(name), affinity(affinity)
+    {
+    }
+
+    ThreadAttributes(Priority priority, unsigned int stackSize, Joinable joinable = JOINABLE, const char* name = "unnamed", AffinityMask affinity = ANY_CPU)
+        : priority(nativePriority(priority)), stackSize(stackSize), joinable(joinable), name(name), affinity(affinity)
+    {
+    }
+};
+
 /** Base interface for all threads. */
 class ThreadInterface
 {
@@ -34,6 +81,26 @@ class ThreadInterface
          */
         virtual bool join(unsigned int timeout) = 0;
 
+        /** Waits for the thread to finish executing, at most until the given deadline.
+         *  @param deadline[in] point in time after which the calling thread stops waiting
+         *  @retval true if the thread was successfully joined before the deadline
+         *  @retval false if the thread was not joined before the deadline or the thread is not joinable at all
+         */
+        bool join(const Deadline& deadline)
+        {
+            return join(deadline.remaining());
+        }
+
+        /** Joins the thread if it already finished, without blocking.
+         *  While the thread is still running this only reads its state, no system call is made and nothing is allocated.
+         *  @retval true if the thread finished and was joined
+         *  @retval false if the thread is still running or the thread is not joinable at all
+         */
+        bool tryJoin()
+        {
+            return join(0U);
+        }
+
         /** Checks, if the thread is joinable.
          *  @retval true if the thread is joinable
          *  @retval false if the thread is not joinable
@@ -59,10 +126,33 @@ class ThreadInterface
          */
         virtual bool setPriority(int priority) = 0;
 
+        /** Sets thread priority to a portable priority level
+         *  @param[in] priority new thread priority
+         *  @retval true if the priority for the thread was set successfully
+         *  @retval false if the priority for the thread was not set successfully for some reason
+         */
+        bool setPriority(Priority priority)
+        {
+            return setPriority(nativePriority(priority));
+        }
+
         /** Gets the thread priority
          *  @return current thread priority
          */
         virtual int getPriority() = 0;
+
+        /** Restricts the thread to a set of cores. Can be called before run(), the mask is then applied on start.
+         *  Systems with a single core accept any mask containing core 0.
+         *  @param[in] affinity mask of the allowed cores, ANY_CPU removes the restriction
+         *  @retval true if the affinity was set successfully
+         *  @retval false if the mask is not valid on this system or the backend does not support affinity
+         */
+        virtual bool setAffinity(AffinityMask affinity) = 0;
+
+        /** Gets the set of cores the thread may run on.
+         *  @return mask of the allowed cores
+         */
+        virtual AffinityMask getAffinity() = 0;
     
         /** Gets thread name
          *  @return name of the thread
@@ -75,6 +165,14 @@ class ThreadInterface
          *  @param time[in] number of milliseconds to delay thread execution
          */
         virtual void sleep(unsigned int time) = 0;
+
+        /** Delays thread execution until the given deadline.
+         *  @param deadline[in] point in time to delay thread execution to
+         */
+        void sleep(const Deadline& deadline)
+        {
+            sleep(deadline.remaining());
+        }
     
         /** Body of the thread - user defined thread function implementation. */
         virtual void job() = 0;
@@ -0,0 +1,293 @@
+#ifndef OSAPI_THREAD_POOL_H
+#define OSAPI_THREAD_POOL_H
+
+/** Pool of worker threads executing small jobs (any callable taking no arguments).
+ *  Every worker is an osapi Thread with its own deque of jobs: it takes jobs from the back
+ *  of its own deque and, when it runs out of work, steals from the front of the other workers' deques.
+ *  submit() may be called from any thread, it spreads jobs across the deques round-robin.
+ *  Idle workers park on a WaitQueue and don't spin.
+ *  Jobs submitted concurrently with shutdown() may be dropped.
+ */
+class ThreadPool
+{
+public:
+    typedef std::function<void()> Job;
+
+private:
+    /** Fixed capacity deque of jobs, guarded by its own lock. */
+    class WorkQueue
+    {
+    private:
+        InternalLock mutex;
+        Job* jobs;
+        unsigned int capacity;
+        unsigned int first;
+        unsigned int count;
+        std::atomic<unsigned int> size;
+
+    public:
+        WorkQueue() : jobs(nullptr), capacity(0U), first(0U), count(0U), size(0U)
+        {
+        }
+
+        ~WorkQueue()
+        {
+            delete[] jobs;
+        }
+
+        void init(unsigned int queueCapacity)
+        {
+            capacity = queueCapacity;
+            jobs = new Job[capacity];
+        }
+
+        bool isEmpty()
+        {
+            return size.load(std::memory_order_relaxed) == 0U;
+        }
+
+        bool pushBack(Job& job)
+        {
+            bool pushed = false;
+            mutex.lock(UINT_MAX);
+            if ( count < capacity )
+            {
+                jobs[(first + count) % capacity] = std::move(job);
+                count++;
+                size.store(count, std::memory_order_relaxed);
+                pushed = true;
+            }
+            mutex.unlock();
+            return pushed;
+        }
+
+        /** Used by the owning worker. */
+        bool popBack(Job& job)
+        {
+            bool popped = false;
+            mutex.lock(UINT_MAX);
+            if ( count != 0U )
+            {
+                count--;
+                job = std::move(jobs[(first + count) % capacity]);
+                size.store(count, std::memory_order_relaxed);
+                popped = true;
+            }
+            mutex.unlock();
+            return popped;
+        }
+
+        /** Used by the other workers (stealing). */
+        bool popFront(Job& job)
+        {
+            bool popped = false;
+            if ( isEmpty() || !mutex.lock(0U) )
+            {
+                return false;
+            }
+            if ( count != 0U )
+            {
+                job = std::move(jobs[first]);
+                first = (first + 1U) % capacity;
+                count--;
+                size.store(count, std::memory_order_relaxed);
+                popped = true;
+            }
+            mutex.unlock();
+            return popped;
+        }
+    };
+
+    class Worker : public Thread
+    {
+    private:
+        ThreadPool& pool;
+        unsigned int index;
+
+    public:
+        Worker(ThreadPool& pool, unsigned int index, int priority, unsigned int stackSize, const char* name)
+            : Thread(priority, stackSize, JOINABLE, name), pool(pool), index(index)
+        {
+        }
+
+    protected:
+        virtual void job()
+        {
+            pool.work(index);
+        }
+    };
+
+    Worker** workers;
+    WorkQueue* queues;
+    unsigned int workerCount;
+    std::atomic<unsigned int> nextQueue;
+    std::atomic<bool> stopping;
+    std::atomic<unsigned int> idleWorkers;
+    std::atomic<unsigned int> wakeEvents;
+    WaitQueue idle;
+
+    bool hasWork()
+    {
+        for ( unsigned int i = 0U; i < workerCount; i++ )
+        {
+            if ( !queues[i].isEmpty() )
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool takeJob(unsigned int index, Job& job)
+    {
+        if ( queues[index].popBack(job) )
+        {
+            return true;
+        }
+        for ( unsigned int i = 1U; i < workerCount; i++ )
+        {
+            if ( queues[(index + i) % workerCount].popFront(job) )
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /** Main loop of a worker thread. */
+    void work(unsigned int index)
+    {
+        Job job;
+        while ( true )
+        {
+            if ( takeJob(index, job) )
+            {
+                job();
+                job = nullptr;
+                continue;
+            }
+            if ( stopping.load() )
+            {
+                break;
+            }
+
+            // park until a job is submitted; re-check after announcing ourselves, so no wake-up gets lost
+            unsigned int seen = wakeEvents.load();
+            idleWorkers.fetch_add(1U);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if ( !hasWork() && !stopping.load() )
+            {
+                idle.wait(wakeEvents, seen, UINT_MAX);
+            }
+            idleWorkers.fetch_sub(1U);
+        }
+    }
+
+public:
+    /** Thread pool constructor, starts the worker threads.
+     *  @param[in] threads number of worker threads
+     *  @param[in] priority priority of the worker threads
+     *  @param[in] stackSize stack size of the worker threads in bytes
+     *  @param[in] name optional name of the worker threads
+     *  @param[in] queueCapacity maximum number of pending jobs per worker
+     */
+    ThreadPool(unsigned int threads, int priority, unsigned int stackSize, const char* name = "pool", unsigned int queueCapacity = 64U)
+        : workerCount(threads != 0U ? threads : 1U), nextQueue(0U), stopping(false), idleWorkers(0U), wakeEvents(0U)
+    {
+        queues = new WorkQueue[workerCount];
+        workers = new Worker*[workerCount];
+        for ( unsigned int i = 0U; i < workerCount; i++ )
+        {
+            queues[i].init(queueCapacity);
+            workers[i] = new Worker(*this, i, priority, stackSize, name);
+        }
+        for ( unsigned int i = 0U; i < workerCount; i++ )
+        {
+            workers[i]->run();
+        }
+    }
+
+    /** Thread pool constructor taking a portable priority level, mapped with nativePriority(). */
+    ThreadPool(unsigned int threads, Priority priority, unsigned int stackSize, const char* name = "pool", unsigned int queueCapacity = 64U)
+        : ThreadPool(threads, nativePriority(priority), stackSize, name, queueCapacity)
+    {
+    }
+
+    /** Destructor, finishes all pending jobs and stops the worker threads. */
+    ~ThreadPool()
+    {
+        shutdown(UINT_MAX);
+        for ( unsigned int i = 0U; i < workerCount; i++ )
+        {
+            delete workers[i];
+        }
+        delete[] workers;
+        delete[] queues;
+    }
+
+    /** Submits a job for execution. May be called from any thread, including the workers.
+     *  @param[in] job callable taking no arguments
+     *  @retval true if the job was queued
+     *  @retval false if all queues are full or the pool is shutting down
+     */
+    template <typename Callable>
+    bool submit(Callable&& job)
+    {
+        if ( stopping.load(std::memory_order_relaxed) )
+        {
+            return false;
+        }
+        Job queued(std::forward<Callable>(job));
+        unsigned int start = nextQueue.fetch_add(1U, std::memory_order_relaxed);
+        for ( unsigned int i = 0U; i < workerCount; i++ )
+        {
+            if ( queues[(start + i) % workerCount].pushBack(queued) )
+            {
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if ( idleWorkers.load(std::memory_order_relaxed) != 0U )
+                {
+                    wakeEvents.fetch_add(1U);
+                    idle.wakeOne(wakeEvents);
+                }
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /** Stops accepting jobs, lets the workers finish the pending ones and waits for them to exit.
+     *  @param[in] timeout maximum number of milliseconds the whole shutdown may take, shared by all workers
+     *  @retval true if all workers exited
+     *  @retval false if some worker did not exit within the given time
+     */
+    bool shutdown(unsigned int timeout)
+    {
+        stopping.store(true);
+        wakeEvents.fetch_add(1U);
+        idle.wakeAll(wakeEvents);
+
+        bool joined = true;
+        Deadline left(timeout);
+        for ( unsigned int i = 0U; i < workerCount; i++ )
+        {
+            // join even if the worker no longer runs, it may still be on its way out of the thread function;
+            // join() fails at once for a worker that never started or was joined by an earlier shutdown()
+            if ( !workers[i]->join(left.remaining()) && workers[i]->isRunning() )
+            {
+                joined = false;
+            }
+        }
+        return joined;
+    }
+
+    /** Gets the number of worker threads.
+     *  @return number of worker threads
+     */
+    unsigned int getWorkerCount()
+    {
+        return workerCount;
+    }
+
+};
+
+#endif // OSAPI_THREAD_POOL_H
@@ -0,0 +1,65 @@
+#ifndef OSAPI_THREAD_REGISTRY_H
+#define OSAPI_THREAD_REGISTRY_H
+
+/** Global list of all running threads, which a diagnostics thread can snapshot, e.g. to export it periodically.
+ *  Threads register when their thread starts and leave when their job() returns (or when they are destroyed).
+ *  The registry is guarded by an InternalLock. A thread leaving the registry waits for a snapshot
+ *  in progress, which guarantees that the backend handles read by the snapshot stay valid.
+ */
+class ThreadRegistry : public Registry<ThreadEntry>
+{
+private:
+    friend class StaticInstance<ThreadRegistry>;
+
+    ThreadRegistry()
+    {
+    }
+
+public:
+    /** Gets the registry. It is created on first use and never destroyed,
+     *  so threads with static storage duration can register and leave in any order.
+     *  @return the global registry
+     */
+    static ThreadRegistry& instance()
+    {
+        return StaticInstance<ThreadRegistry>::get();
+    }
+
+    /** Copies the counters of the registered threads.
+     *  The registry stays locked only while the threads' own counters are copied; counters the backend reads
+     *  from the system (/proc on Linux) are filled in afterwards, so starting and exiting threads are not held up.
+     *  @param[out] statistics array receiving the copies
+     *  @param[in] max size of the array
+     *  @return number of copied entries
+     */
+    unsigned int snapshot(ThreadStatistics* statistics, unsigned int max)
+    {
+        unsigned int copied = 0U;
+        forEach([&](ThreadEntry& entry) -> bool {
+            if ( copied == max )
+            {
+                return false;
+            }
+            entry.read(statistics[copied++]);
+            return true;
+        });
+        for ( unsigned int i = 0U; i < copied; i++ )
+        {
+            Thread::finishStatistics(statistics[i]);
+        }
+        return copied;
+    }
+
+};
+
+inline bool registerThread(ThreadEntry& entry)
+{
+    return ThreadRegistry::instance().add(entry);
+}
+
+inline void unregisterThread(ThreadEntry& entry)
+{
+    ThreadRegistry::instance().remove(entry);
+}
+
+#endif // OSAPI_THREAD_REGISTRY_H
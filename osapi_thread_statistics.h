@@ -0,0 +1,92 @@
+#ifndef OSAPI_THREAD_STATISTICS_H
+#define OSAPI_THREAD_STATISTICS_H
+
+/** Scheduling state of a thread as reported by ThreadRegistry::snapshot(). */
+typedef enum {
+    THREAD_UNKNOWN = 0,
+    THREAD_RUNNING = 1,
+    THREAD_READY = 2,
+    THREAD_BLOCKED = 3,
+    THREAD_SUSPENDED = 4,
+    THREAD_TERMINATED = 5
+} ThreadState;
+
+/** Copy of the scheduling counters of one registered thread, see ThreadRegistry::snapshot().
+ *  Counters the backend does not track are left 0.
+ */
+struct ThreadStatistics
+{
+    const char* name;
+    int priority;
+    ThreadState state;
+    /** CPU time consumed by the thread in nanoseconds */
+    unsigned long long cpuTime;
+    /** number of times the thread gave up the CPU by blocking */
+    unsigned long voluntarySwitches;
+    /** number of times the thread was preempted */
+    unsigned long involuntarySwitches;
+    /** stack never used so far in bytes */
+    unsigned long stackFree;
+    /** kernel id of the thread where the backend reads counters by it (the tid on Linux), 0 otherwise */
+    unsigned long nativeId;
+};
+
+class ThreadEntry;
+
+inline bool registerThread(ThreadEntry& entry);
+inline void unregisterThread(ThreadEntry& entry);
+
+/** Link of a thread in the ThreadRegistry, kept by every thread.
+ *  The reader fills in the backend specific counters, it is called with the registry locked. Counters which take
+ *  longer to read (e.g. from files) are left to Thread::finishStatistics(), called after the registry is unlocked.
+ */
+class ThreadEntry
+{
+    template <typename Entry>
+    friend class Registry;
+
+public:
+    typedef void (*Reader)(ThreadInterface& thread, ThreadStatistics& statistics);
+
+private:
+    ThreadInterface& threaD;
+    Reader readeR;
+    ThreadEntry* next;
+    ThreadEntry** link;
+
+public:
+    /** Entry constructor, the entry is not registered before the thread runs.
+     *  @param[in] thread thread described by the entry
+     *  @param[in] reader function filling in the backend specific counters of the thread
+     */
+    ThreadEntry(ThreadInterface& thread, Reader reader) : threaD(thread), readeR(reader), next(nullptr), link(nullptr)
+    {
+    }
+
+    ~ThreadEntry()
+    {
+        unregisterThread(*this);
+    }
+
+    ThreadEntry(const ThreadEntry&) = delete;
+    ThreadEntry& operator=(const ThreadEntry&) = delete;
+
+    /** Copies the counters of the thread.
+     *  @param[out] statistics receives the counters
+     */
+    void read(ThreadStatistics& statistics)
+    {
+        statistics.name = threaD.getName();
+        statistics.priority = threaD.getPriority();
+        statistics.state = THREAD_UNKNOWN;
+        statistics.cpuTime = 0ULL;
+        statistics.voluntarySwitches = 0UL;
+        statistics.involuntarySwitches = 0UL;
+        statistics.stackFree = 0UL;
+        statistics.nativeId = 0UL;
+        readeR(threaD, statistics);
+    }
+
+};
+
+#endif // OSAPI_THREAD_STATISTICS_H
@@ -0,0 +1,470 @@
+#ifndef OSAPI_TIMER_SERVICE_H
+#define OSAPI_TIMER_SERVICE_H
+
+#ifndef OSAPI_TIMER_WHEEL_LEVELS
+/** Number of levels of the timing wheel; with 64 slots per level, 4 levels span 2^24 ticks. */
+#define OSAPI_TIMER_WHEEL_LEVELS 4U
+#endif
+
+class TimerService;
+
+/** Software timer handled by a TimerService. The timer object is owned by the user and linked into
+ *  the wheel of the service (intrusive), so starting and cancelling it never allocates.
+ *  A timer has to stay alive while its callback runs; the destructor cancels a pending timer.
+ */
+class Timer
+{
+    friend class TimerService;
+
+public:
+    typedef std::function<void()> Callback;
+
+private:
+    static const unsigned int IDLE = 0U;
+    static const unsigned int ARMED = 1U;
+    static const unsigned int RUNNING = 2U;
+
+    Callback callback;
+    TimerService* service;
+    Timer* next;
+    Timer** link;
+    unsigned long long dueNanos;
+    unsigned long long expiryTick;
+    unsigned int perioD;
+    std::atomic<unsigned int> state;
+
+public:
+    /** Timer constructor.
+     *  @param[in] callback function called when the timer expires
+     */
+    Timer(Callback callback)
+        : callback(callback), service(nullptr), next(nullptr), link(nullptr), dueNanos(0ULL), expiryTick(0ULL), perioD(0U), state(IDLE)
+    {
+    }
+
+    ~Timer();
+
+    /** Checks if the timer waits for its expiry.
+     *  @retval true if the timer is started and did not expire yet (or is periodic)
+     *  @retval false otherwise
+     */
+    bool isArmed()
+    {
+        return state.load(std::memory_order_relaxed) == ARMED;
+    }
+
+    /** Gets the period.
+     *  @return number of milliseconds between two expiries, 0 for a one-shot timer
+     */
+    unsigned int getPeriod()
+    {
+        return perioD;
+    }
+
+};
+
+/** Dispatch statistics of a timer service. Lateness is the delay between the due time of a timer
+ *  and the call of its callback (or its hand-over to the thread pool), in nanoseconds.
+ */
+struct TimerStatistics
+{
+    /** number of dispatched callbacks */
+    unsigned long dispatched;
+    /** number of periods skipped, because a periodic timer was dispatched more than one period late */
+    unsigned long skipped;
+    /** number of callbacks dropped, because the thread pool did not accept them */
+    unsigned long rejected;
+    unsigned long long minLateness;
+    unsigned long long averageLateness;
+    unsigned long long maxLateness;
+};
+
+/** Runs any number of one-shot and periodic timers on a single thread, instead of one thread per timer.
+ *  Timers are kept in a hierarchical timing wheel (OSAPI_TIMER_WHEEL_LEVELS levels of 64 slots),
+ *  so starting and cancelling a timer is O(1) regardless of the number of timers.
+ *  Due times follow monotonicNanos() and are rounded up to the resolution of the wheel; periodic timers
+ *  are rescheduled from their due time, so they don't drift.
+ *  Callbacks run either inline on the service thread (keep them short) or are submitted to a ThreadPool.
+ *  Call run() to start the service and shutdown() (rather than kill()) to stop it, which also wakes it up.
+ */
+class TimerService : public BasicMortalThread<TimerService>
+{
+    friend class BasicMortalThread<TimerService>;
+
+private:
+    static const unsigned int SLOT_BITS = 6U;
+    static const unsigned int SLOTS = 1U << SLOT_BITS;
+    static const unsigned int SLOT_MASK = SLOTS - 1U;
+    static const unsigned long long WHEEL_SPAN = 1ULL << (SLOT_BITS * OSAPI_TIMER_WHEEL_LEVELS);
+
+    InternalLock mutex;
+    Timer* wheel[OSAPI_TIMER_WHEEL_LEVELS][SLOTS];
+    Timer* expired;
+    /** next tick to be processed */
+    unsigned long long tick;
+    unsigned long long origin;
+    unsigned long long tickNanos;
+    ThreadPool* pool;
+    /** tick the service thread sleeps until */
+    unsigned long long wakeTick;
+    std::atomic<unsigned int> wakeEvents;
+    WaitQueue wakeUp;
+
+    TimerStatistics statistics;
+    unsigned long long latenessSum;
+
+    static void push(Timer*& head, Timer& timer)
+    {
+        timer.next = head;
+        if ( head != nullptr )
+        {
+            head->link = &timer.next;
+        }
+        head = &timer;
+        timer.link = &head;
+    }
+
+    static void unlink(Timer& timer)
+    {
+        *timer.link = timer.next;
+        if ( timer.next != nullptr )
+        {
+            timer.next->link = timer.link;
+        }
+        timer.next = nullptr;
+        timer.link = nullptr;
+    }
+
+    static void detach(Timer*& head)
+    {
+        while ( head != nullptr )
+        {
+            Timer* timer = head;
+            unlink(*timer);
+            timer->service = nullptr;
+            timer->state.store(Timer::IDLE, std::memory_order_relaxed);
+        }
+    }
+
+    unsigned long long nanosToTick(unsigned long long nanos)
+    {
+        return nanos <= origin ? 0ULL : (nanos - origin + tickNanos - 1ULL) / tickNanos;
+    }
+
+    /** Puts the timer into the slot matching its expiry. Called with the mutex locked. */
+    void insert(Timer& timer)
+    {
+        unsigned long long expiry = timer.expiryTick;
+        if ( expiry < tick )
+        {
+            expiry = tick;
+        }
+        unsigned long long delta = expiry - tick;
+        if ( delta >= WHEEL_SPAN )
+        {
+            // beyond the wheel: park in the farthest slot, it moves closer at every cascade
+            expiry = tick + WHEEL_SPAN - 1ULL;
+            delta = WHEEL_SPAN - 1ULL;
+        }
+        unsigned int level = 0U;
+        while ( delta >= (1ULL << (SLOT_BITS * (level + 1U))) )
+        {
+            level++;
+        }
+        push(wheel[level][(expiry >> (SLOT_BITS * level)) & SLOT_MASK], timer);
+    }
+
+    /** Moves the timers of a slot of an upper level down to the lower levels. */
+    void cascade(unsigned int level)
+    {
+        Timer*& slot = wheel[level][(tick >> (SLOT_BITS * level)) & SLOT_MASK];
+        Timer* timer = slot;
+        slot = nullptr;
+        while ( timer != nullptr )
+        {
+            Timer* following = timer->next;
+            timer->link = nullptr;
+            insert(*timer);
+            timer = following;
+        }
+    }
+
+    /** Processes all ticks up to the given one, collecting expired timers. Called with the mutex locked. */
+    void advance(unsigned long long until)
+    {
+        while ( tick <= until )
+        {
+            unsigned int index = (unsigned int)(tick & SLOT_MASK);
+            for ( unsigned int level = 1U; index == 0U && level < OSAPI_TIMER_WHEEL_LEVELS; level++ )
+            {
+                cascade(level);
+                index = (unsigned int)((tick >> (SLOT_BITS * level)) & SLOT_MASK);
+            }
+            Timer* timer = wheel[0][tick & SLOT_MASK];
+            wheel[0][tick & SLOT_MASK] = nullptr;
+            while ( timer != nullptr )
+            {
+                Timer* following = timer->next;
+                push(expired, *timer);
+                timer = following;
+            }
+            tick++;
+        }
+    }
+
+    /** Finds the tick to sleep until: the next non-empty slot of the lowest level, or the next cascade. */
+    unsigned long long nextWakeTick()
+    {
+        unsigned int index = (unsigned int)(tick & SLOT_MASK);
+        for ( unsigned int i = index; i < SLOTS; i++ )
+        {
+            if ( wheel[0][i] != nullptr )
+            {
+                return tick + (i - index);
+            }
+        }
+        return tick + (SLOTS - index);
+    }
+
+    void record(unsigned long long lateness)
+    {
+        if ( statistics.dispatched == 0UL || lateness < statistics.minLateness ) statistics.minLateness = lateness;
+        if ( lateness > statistics.maxLateness ) statistics.maxLateness = lateness;
+        statistics.dispatched++;
+        latenessSum += lateness;
+        statistics.averageLateness = latenessSum / statistics.dispatched;
+    }
+
+    /** Schedules the next expiry of a periodic timer. Called with the mutex locked. */
+    void rearm(Timer& timer, unsigned long long now)
+    {
+        unsigned long long period = (unsigned long long)timer.perioD * 1000000ULL;
+        timer.dueNanos += period;
+        if ( timer.dueNanos < now )
+        {
+            unsigned long long missed = (now - timer.dueNanos) / period + 1ULL;
+            timer.dueNanos += missed * period;
+            statistics.skipped += (unsigned long)missed;
+        }
+        timer.expiryTick = nanosToTick(timer.dueNanos);
+        timer.state.store(Timer::ARMED, std::memory_order_relaxed);
+        insert(timer);
+    }
+
+    /** Calls (or hands over) the callbacks of all expired timers. Called with the mutex locked. */
+    void dispatch()
+    {
+        while ( expired != nullptr )
+        {
+            Timer& timer = *expired;
+            unlink(timer);
+            unsigned long long now = monotonicNanos();
+            record(now > timer.dueNanos ? now - timer.dueNanos : 0ULL);
+
+            if ( pool != nullptr )
+            {
+                if ( !pool->submit(timer.callback) )
+                {
+                    statistics.rejected++;
+                }
+                if ( timer.perioD != 0U )
+                {
+                    rearm(timer, now);
+                }
+                else
+                {
+                    timer.state.store(Timer::IDLE, std::memory_order_relaxed);
+                }
+                continue;
+            }
+
+            // the callback may start or cancel timers (including this one), so it runs unlocked
+            timer.state.store(Timer::RUNNING, std::memory_order_relaxed);
+            mutex.unlock();
+            timer.callback();
+            mutex.lock(UINT_MAX);
+            if ( timer.state.load(std::memory_order_relaxed) == Timer::RUNNING )
+            {
+                if ( timer.perioD != 0U )
+                {
+                    rearm(timer, now);
+                }
+                else
+                {
+                    timer.state.store(Timer::IDLE, std::memory_order_relaxed);
+                }
+            }
+        }
+    }
+
+    void begin()
+    {
+    }
+
+    void end()
+    {
+    }
+
+    /** Replaces the free running loop of BasicMortalThread. */
+    void mainLoop()
+    {
+        while ( !isKilled() )
+        {
+            mutex.lock(UINT_MAX);
+            advance((monotonicNanos() - origin) / tickNanos);
+            dispatch();
+            wakeTick = nextWakeTick();
+            unsigned int seen = wakeEvents.load();
+            Deadline until = Deadline::atNanos(origin + wakeTick * tickNanos);
+            mutex.unlock();
+
+            unsigned int remaining = until.remaining();
+            if ( remaining != 0U && !isKilled() )
+            {
+                wakeUp.wait(wakeEvents, seen, remaining);
+            }
+        }
+    }
+
+public:
+    /** Timer service constructor. The service starts with run().
+     *  @param[in] priority priority of the service thread
+     *  @param[in] stackSize stack size of the service thread in bytes
+     *  @param[in] resolution length of a wheel tick in milliseconds, due times are rounded up to it
+     *  @param[in] pool optional thread pool executing the callbacks, nullptr runs them on the service thread
+     *  @param[in] name optional thread name
+     */
+    TimerService(int priority, unsigned int stackSize, unsigned int resolution = 1U, ThreadPool* pool = nullptr, const char* name = "timers")
+        : BasicMortalThread<TimerService>(priority, stackSize, name), expired(nullptr), tick(0ULL), origin(monotonicNanos()),
+          tickNanos((unsigned long long)(resolution != 0U ? resolution : 1U) * 1000000ULL), pool(pool), wakeTick(0ULL), wakeEvents(0U)
+    {
+        for ( unsigned int level = 0U; level < OSAPI_TIMER_WHEEL_LEVELS; level++ )
+        {
+            for ( unsigned int slot = 0U; slot < SLOTS; slot++ )
+            {
+                wheel[level][slot] = nullptr;
+            }
+        }
+        resetStatistics();
+    }
+
+    /** Timer service constructor taking a portable priority level, mapped with nativePriority(). */
+    TimerService(Priority priority, unsigned int stackSize, unsigned int resolution = 1U, ThreadPool* pool = nullptr, const char* name = "timers")
+        : TimerService(nativePriority(priority), stackSize, resolution, pool, name)
+    {
+    }
+
+    /** Destructor, stops the service thread. Timers still armed are detached and left idle. */
+    virtual ~TimerService()
+    {
+        shutdown(UINT_MAX);
+        for ( unsigned int level = 0U; level < OSAPI_TIMER_WHEEL_LEVELS; level++ )
+        {
+            for ( unsigned int slot = 0U; slot < SLOTS; slot++ )
+            {
+                detach(wheel[level][slot]);
+            }
+        }
+        detach(expired);
+    }
+
+    /** Starts (or restarts) a timer.
+     *  @param[in] timer timer to start, a pending expiry is cancelled first
+     *  @param[in] delay number of milliseconds until the first expiry
+     *  @param[in] period number of milliseconds between further expiries, 0 for a one-shot timer
+     *  @retval true if the timer was started
+     *  @retval false if the timer belongs to another service
+     */
+    bool start(Timer& timer, unsigned int delay, unsigned int period = 0U)
+    {
+        mutex.lock(UINT_MAX);
+        if ( timer.service != nullptr && timer.service != this )
+        {
+            mutex.unlock();
+            return false;
+        }
+        if ( timer.link != nullptr )
+        {
+            unlink(timer);
+        }
+        timer.service = this;
+        timer.perioD = period;
+        timer.dueNanos = monotonicNanos() + (unsigned long long)delay * 1000000ULL;
+        timer.expiryTick = nanosToTick(timer.dueNanos);
+        timer.state.store(Timer::ARMED, std::memory_order_relaxed);
+        insert(timer);
+        bool earlier = timer.expiryTick < wakeTick;
+        mutex.unlock();
+
+        if ( earlier )
+        {
+            wakeEvents.fetch_add(1U);
+            wakeUp.wakeOne(wakeEvents);
+        }
+        return true;
+    }
+
+    /** Cancels a timer. A callback already running is not waited for.
+     *  @param[in] timer timer to cancel
+     *  @retval true if the timer was armed
+     *  @retval false if the timer was idle
+     */
+    bool cancel(Timer& timer)
+    {
+        mutex.lock(UINT_MAX);
+        bool armed = timer.state.load(std::memory_order_relaxed) == Timer::ARMED;
+        if ( timer.link != nullptr )
+        {
+            unlink(timer);
+        }
+        timer.state.store(Timer::IDLE, std::memory_order_relaxed);
+        mutex.unlock();
+        return armed;
+    }
+
+    /** Stops the service thread and waits for it to exit.
+     *  @param[in] timeout maximum number of milliseconds to wait
+     *  @retval true if the service thread exited (or was not running)
+     *  @retval false if it did not exit within the given time
+     */
+    bool shutdown(unsigned int timeout)
+    {
+        kill();
+        wakeEvents.fetch_add(1U);
+        wakeUp.wakeAll(wakeEvents);
+        // join even if the thread no longer runs, it may still be on its way out of the thread function;
+        // join() fails at once if the service was never started or already joined
+        return join(timeout) || !isRunning();
+    }
+
+    /** Gets a consistent copy of the dispatch statistics.
+     *  @return dispatch statistics collected since the start or since the last resetStatistics()
+     */
+    TimerStatistics getStatistics()
+    {
+        mutex.lock(UINT_MAX);
+        TimerStatistics copy = statistics;
+        mutex.unlock();
+        return copy;
+    }
+
+    /** Clears the dispatch statistics. */
+    void resetStatistics()
+    {
+        mutex.lock(UINT_MAX);
+        memset(&statistics, 0, sizeof(statistics));
+        latenessSum = 0ULL;
+        mutex.unlock();
+    }
+
+};
+
+inline Timer::~Timer()
+{
+    if ( service != nullptr )
+    {
+        service->cancel(*this);
+    }
+}
+
+#endif // OSAPI_TIMER_SERVICE_H
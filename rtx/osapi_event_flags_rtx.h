@@ -0,0 +1,59 @@
+#ifndef OSAPI_EVENT_FLAGS_RTX_H
+#define OSAPI_EVENT_FLAGS_RTX_H
+
+#include "osapi.h"
+
+/** Event flags mapped onto RTX event flags (31 usable bits). */
+class EventFlags : public EventFlagsInterface
+{
+	private:
+		osEventFlagsId_t event_id;
+
+		/** RTX reports errors as negative values, i.e. with the top bit set. */
+		static bool isError(uint32_t result)
+		{
+			return ( result & osFlagsError ) != 0U;
+		}
+
+	public:
+		EventFlags()
+		{
+			event_id = osEventFlagsNew(NULL);
+		}
+
+		virtual ~EventFlags()
+		{
+			if (event_id != nullptr) osEventFlagsDelete(event_id);
+		}
+
+		virtual unsigned int set(unsigned int flags) final
+		{
+			uint32_t result = osEventFlagsSet(event_id, flags);
+			return isError(result) ? 0U : (unsigned int)result;
+		}
+
+		virtual unsigned int clear(unsigned int flags) final
+		{
+			uint32_t result = osEventFlagsClear(event_id, flags);
+			return isError(result) ? 0U : (unsigned int)result;
+		}
+
+		virtual unsigned int get() final
+		{
+			return (unsigned int)osEventFlagsGet(event_id);
+		}
+
+		virtual unsigned int wait(unsigned int flags, EventWait mode, bool clearOnExit, unsigned int timeout) final
+		{
+			uint32_t options = ( mode == WAIT_ALL ) ? osFlagsWaitAll : osFlagsWaitAny;
+			if ( !clearOnExit )
+			{
+				options |= osFlagsNoClear;
+			}
+			uint32_t result = osEventFlagsWait(event_id, flags, options, msToTicks(timeout));
+			return isError(result) ? 0U : (unsigned int)result;
+		}
+
+};
+
+#endif // OSAPI_EVENT_FLAGS_RTX_H
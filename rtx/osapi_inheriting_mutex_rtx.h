@@ -0,0 +1,51 @@
+#ifndef OSAPI_INHERITING_MUTEX_RTX_H
+#define OSAPI_INHERITING_MUTEX_RTX_H
+
+#include "osapi.h"
+
+/** Mutex with priority inheritance for RTX (osMutexPrioInherit).
+ *  While a higher priority thread waits, the owner runs with the priority of that thread.
+ */
+class InheritingMutex : public BasicMutex<InheritingMutex>
+{
+	friend class BasicMutex<InheritingMutex>;
+
+private:
+	osMutexAttr_t attr;
+	osMutexId_t mutex_id;
+	OnceFlag created;
+
+public:
+	/** Inheriting mutex constructor.
+	 *  @param[in] name optional name, reported by the mutex profiling (OSAPI_MUTEX_PROFILING)
+	 */
+	InheritingMutex(const char* name = nullptr) : BasicMutex<InheritingMutex>(name), mutex_id(nullptr)
+	{
+		attr = { name, osMutexPrioInherit, NULL, 0U };
+	}
+
+	virtual ~InheritingMutex()
+	{
+		if (mutex_id != nullptr) osMutexDelete(mutex_id);
+	}
+
+private:
+	bool lockImpl(unsigned int timeout)
+	{
+		// created on first use, as static objects are constructed before osKernelInitialize()
+		// retried on the next lock() if the kernel could not create it yet
+		if (!tryCallOnce(created, [this]() { mutex_id = osMutexNew(&attr); return mutex_id != nullptr; }))
+		{
+			return false;
+		}
+		return osMutexAcquire(mutex_id, msToTicks(timeout)) == osOK ? true : false;
+	}
+
+	void unlockImpl()
+	{
+		if (mutex_id != nullptr) osMutexRelease(mutex_id);
+	}
+
+};
+
+#endif // OSAPI_INHERITING_MUTEX_RTX_H
@@ -3,17 +3,23 @@
 
 #include "osapi.h"
 
-class Mutex : public MutexInterface
+class Mutex : public BasicMutex<Mutex>
 {
+	friend class BasicMutex<Mutex>;
+
 private:
 	osMutexAttr_t Thread_Mutex_attr;
 	osMutexId_t mutex_id;
 	osStatus_t status;
+	OnceFlag created;
 
 public:
-	Mutex()
+	/** Mutex constructor.
+	 *  @param[in] name optional name, reported by the mutex profiling (OSAPI_MUTEX_PROFILING)
+	 */
+	Mutex(const char* name = nullptr) : BasicMutex<Mutex>(name), mutex_id(nullptr)
 	{
-			Thread_Mutex_attr.attr_bits = osMutexRobust;
+		Thread_Mutex_attr = { name, osMutexRobust, NULL, 0U };
 	}
 	
 	virtual ~Mutex()
@@ -21,15 +27,16 @@ public:
 		if (mutex_id) osMutexDelete(mutex_id);
 	}
 	
-	virtual bool lock(unsigned int timeout)
+private:
+	bool lockImpl(unsigned int timeout)
 	{
-		int32_t state = osKernelLock();
-		if (mutex_id == nullptr)
+		// created on first use, as static objects are constructed before osKernelInitialize()
+		// retried on the next lock() if the kernel could not create it yet
+		if (!tryCallOnce(created, [this]() { mutex_id = osMutexNew(&Thread_Mutex_attr); return mutex_id != nullptr; }))
 		{
-			mutex_id = osMutexNew(&Thread_Mutex_attr);
+			return false;
 		}
-		osKernelRestoreLock( state );
-		status = osMutexAcquire ( mutex_id, timeout);
+		status = osMutexAcquire ( mutex_id, msToTicks(timeout));
 		if ( status == osOK )
 		{
 			return true;
@@ -37,7 +44,7 @@ public:
 		return false;
 	}
 	
-	virtual void unlock()
+	void unlockImpl()
 	{
 		if (mutex_id != nullptr) status = osMutexRelease( mutex_id );
 	}
@@ -3,16 +3,23 @@
 
 #include "osapi.h"
 
-class RecursiveMutex : public MutexInterface
+class RecursiveMutex : public BasicMutex<RecursiveMutex>
 {
+	friend class BasicMutex<RecursiveMutex>;
+
 private:
 	osMutexAttr_t Thread_Mutex_attr;
 	osMutexId_t mutex_id;
 	osStatus_t status;
+	OnceFlag created;
 
 public:
-	RecursiveMutex() {
-		Thread_Mutex_attr.attr_bits = osMutexRecursive;
+	/** Recursive mutex constructor.
+	 *  @param[in] name optional name, reported by the mutex profiling (OSAPI_MUTEX_PROFILING)
+	 */
+	RecursiveMutex(const char* name = nullptr) : BasicMutex<RecursiveMutex>(name), mutex_id(nullptr)
+	{
+		Thread_Mutex_attr = { name, osMutexRecursive, NULL, 0U };
 	}
 	
 	virtual ~RecursiveMutex()
@@ -20,15 +27,16 @@ public:
 		if (mutex_id) osMutexDelete(mutex_id);
 	}
 	
-	virtual bool lock(unsigned int timeout)
+private:
+	bool lockImpl(unsigned int timeout)
 	{
-		int32_t state = osKernelLock();
-		if (mutex_id == nullptr)
+		// created on first use, as static objects are constructed before osKernelInitialize()
+		// retried on the next lock() if the kernel could not create it yet
+		if (!tryCallOnce(created, [this]() { mutex_id = osMutexNew(&Thread_Mutex_attr); return mutex_id != nullptr; }))
 		{
-			mutex_id = osMutexNew(&Thread_Mutex_attr);
+			return false;
 		}
-		osKernelRestoreLock(state);
-		status = osMutexAcquire ( mutex_id, timeout);
+		status = osMutexAcquire ( mutex_id, msToTicks(timeout));
 		if ( status == osOK )
 		{
 			return true;
@@ -36,7 +44,7 @@ public:
 		return false;
 	}
 	
-	virtual void unlock()
+	void unlockImpl()
 	{
 		if (mutex_id != nullptr) status = osMutexRelease( mutex_id );
 	}
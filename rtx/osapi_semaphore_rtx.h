@@ -0,0 +1,138 @@
+#ifndef OSAPI_SEMAPHORE_RTX_H
+#define OSAPI_SEMAPHORE_RTX_H
+
+#include "osapi.h"
+
+#ifndef OSAPI_SIGNAL_THREAD_FLAG
+/** Thread flag used by Signal to wake up the waiting thread. */
+#define OSAPI_SIGNAL_THREAD_FLAG 0x40000000U
+#endif
+
+/** Counting semaphore mapped onto an RTX semaphore. */
+class Semaphore
+{
+private:
+	osSemaphoreId_t sid_Semaphore;
+
+public:
+	/** Semaphore constructor.
+	 *  @param[in] initial initial count
+	 *  @param[in] max maximum count
+	 */
+	Semaphore(unsigned int initial, unsigned int max)
+	{
+		sid_Semaphore = osSemaphoreNew(max, initial < max ? initial : max, NULL);
+	}
+
+	~Semaphore()
+	{
+		if (sid_Semaphore != nullptr) osSemaphoreDelete(sid_Semaphore);
+	}
+
+	/** Decrements the count, if it is not zero.
+	 *  @retval true if the semaphore was acquired
+	 *  @retval false if the count was zero
+	 */
+	bool tryAcquire()
+	{
+		return acquire(0U);
+	}
+
+	/** Decrements the count. While it is zero, blocks the calling thread for the maximum given timeout.
+	 *  @param[in] timeout maximum number of milliseconds to block the calling thread
+	 *  @retval true if the semaphore was acquired
+	 *  @retval false if the semaphore was not acquired within the given time
+	 */
+	bool acquire(unsigned int timeout)
+	{
+		if (sid_Semaphore == nullptr)
+		{
+			return false;
+		}
+		return osSemaphoreAcquire(sid_Semaphore, msToTicks(timeout)) == osOK ? true : false;
+	}
+
+	/** Increments the count and wakes up as many blocked threads.
+	 *  @param[in] n number of releases
+	 *  @retval true if the count was incremented n times
+	 *  @retval false if the count reached the maximum before
+	 */
+	bool release(unsigned int n = 1U)
+	{
+		if (sid_Semaphore == nullptr)
+		{
+			return false;
+		}
+		for ( ; n != 0U; n-- )
+		{
+			if (osSemaphoreRelease(sid_Semaphore) != osOK)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+};
+
+/** Binary signal with a single waiting thread, built on RTX thread flags (OSAPI_SIGNAL_THREAD_FLAG of the waiting thread).
+ *  post() may be called from any thread; posts made while the signal is already set are merged.
+ */
+class Signal
+{
+private:
+	std::atomic<osThreadId_t> waiter;
+	std::atomic<unsigned int> posted;
+
+public:
+	Signal() : waiter(nullptr), posted(0U)
+	{
+	}
+
+	/** Sets the signal and wakes up the waiting thread. */
+	void post()
+	{
+		posted.store(1U);
+		osThreadId_t thread = waiter.load();
+		if (thread != nullptr)
+		{
+			osThreadFlagsSet(thread, OSAPI_SIGNAL_THREAD_FLAG);
+		}
+	}
+
+	/** Waits until the signal is set and clears it. Only one thread may wait at a time.
+	 *  @param[in] timeout maximum number of milliseconds to block the calling thread
+	 *  @retval true if the signal was set
+	 *  @retval false if the signal was not set within the given time
+	 */
+	bool wait(unsigned int timeout)
+	{
+		if (posted.exchange(0U) != 0U)
+		{
+			return true;
+		}
+		if (timeout == 0U)
+		{
+			return false;
+		}
+
+		Deadline left(timeout);
+		bool set;
+		waiter.store(osThreadGetId());
+		// a flag left over from an earlier post() only causes another round
+		while ( !( set = posted.exchange(0U) != 0U ) )
+		{
+			unsigned int remaining = left.remaining();
+			if (remaining == 0U)
+			{
+				break;
+			}
+			osThreadFlagsWait(OSAPI_SIGNAL_THREAD_FLAG, osFlagsWaitAny, msToTicks(remaining));
+		}
+		waiter.store(nullptr);
+		return set;
+	}
+
+};
+
+#endif // OSAPI_SEMAPHORE_RTX_H
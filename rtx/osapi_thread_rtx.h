@@ -2,20 +2,58 @@
 #define OSAPI_THREAD_RTX_H
 
 #include "osapi.h"
+
+#ifndef OSAPI_JOIN_THREAD_FLAG
+/** Thread flag used to wake up the thread waiting in join(). */
+#define OSAPI_JOIN_THREAD_FLAG 0x20000000U
+#endif
+
+#ifndef OSAPI_WAKE_THREAD_FLAG
+/** Thread flag set by Thread::sendWakeUp(), e.g. to wake up a MortalThread on kill(). */
+#define OSAPI_WAKE_THREAD_FLAG 0x40000000U
+#endif
+
+/** Memory for the thread control block, provided together with the stack to create a thread without the heap. */
+typedef osRtxThread_t ThreadControlBlock;
+
+/** Maps the portable priority levels to the osPriority_t values, see Priority.
+ *  @param[in] priority portable priority level
+ *  @return priority for osThreadNew()
+ */
+inline int nativePriority(Priority priority)
+{
+  switch ( priority )
+  {
+    case PRIORITY_IDLE: return osPriorityIdle;
+    case PRIORITY_LOW: return osPriorityLow;
+    case PRIORITY_BELOW_NORMAL: return osPriorityBelowNormal;
+    case PRIORITY_ABOVE_NORMAL: return osPriorityAboveNormal;
+    case PRIORITY_HIGH: return osPriorityHigh;
+    case PRIORITY_REALTIME: return osPriorityRealtime;
+    default: return osPriorityNormal;
+  }
+}
+
 /** Thread interface implementation for RTX. */
 
-class Thread : public ThreadInterface
+class Thread : public BasicThread<Thread>
 {
+			friend class BasicThread<Thread>;
+
 	private:
 			int prioritY;
 			const char* namE;
+			AffinityMask affinitY;
 			unsigned int stackSizE;
 			Joinable joinablE;
 			osThreadId_t thread1_id;
 			osThreadAttr_t threadAttr_thread1;
 			osStatus_t status;
 			osThreadState_t state;
-			osSemaphoreId_t sid_Semaphore;
+			/** JOIN_NONE, JOIN_EXITED or the id of the thread waiting in join() */
+			std::atomic<uintptr_t> joinState;
+			void* stackMemorY;
+			ThreadControlBlock* controlBlocK;
 
   public:
       /** Thread constructor.
@@ -28,22 +66,72 @@ class Thread : public ThreadInterface
       {
         prioritY = priority;
         namE = name;
+        affinitY = ANY_CPU;
+        stackSizE = stackSize;
+        joinablE = isJoinable;
+        joinState = JOIN_NONE;
+        thread1_id = NULL;
+        stackMemorY = NULL;
+        controlBlocK = NULL;
+      }
+
+      /** Thread constructor for statically allocated threads, run() does not use the heap.
+        *  @param[in] priority thread priority
+        *  @param[in] stackSize size of the provided stack in bytes (multiple of 8)
+        *  @param[in] isJoinable decides if the thread supports join operation or not
+        *  @param[in] stackMemory memory for the thread stack, 8-byte aligned
+        *  @param[in] controlBlock memory for the thread control block
+        *  @param[in] name optional thread name
+        */
+      Thread(int priority, unsigned int stackSize, Joinable isJoinable, void* stackMemory, ThreadControlBlock* controlBlock, const char* name = "unnamed")
+      {
+        prioritY = priority;
+        namE = name;
+        affinitY = ANY_CPU;
         stackSizE = stackSize;
         joinablE = isJoinable;
-        sid_Semaphore = osSemaphoreNew(1U, 0U, NULL);
+        joinState = JOIN_NONE;
+        thread1_id = NULL;
+        stackMemorY = stackMemory;
+        controlBlocK = controlBlock;
+      }
+
+      /** Thread constructor taking a portable priority level, mapped with nativePriority(). */
+      Thread(Priority priority, unsigned int stackSize, Joinable isJoinable, const char* name = "unnamed")
+        : Thread(nativePriority(priority), stackSize, isJoinable, name)
+      {
+      }
+
+      /** Constructor for statically allocated threads taking a portable priority level, mapped with nativePriority(). */
+      Thread(Priority priority, unsigned int stackSize, Joinable isJoinable, void* stackMemory, ThreadControlBlock* controlBlock, const char* name = "unnamed")
+        : Thread(nativePriority(priority), stackSize, isJoinable, stackMemory, controlBlock, name)
+      {
+      }
+
+      /** Thread constructor taking all creation parameters at once.
+        *  @param[in] attributes priority, stack size, joinability, name and affinity of the thread
+        */
+      Thread(const ThreadAttributes& attributes)
+        : Thread(attributes.priority, attributes.stackSize, attributes.joinable, attributes.name)
+      {
+        affinitY = attributes.affinity;
       }
 
       /** Virtual destructor required to properly destroy derived class objects. */
       virtual ~Thread()
       { 
-        osSemaphoreDelete(sid_Semaphore);
       }
       
+  private:
+
+      static const uintptr_t JOIN_NONE = 0U;
+      static const uintptr_t JOIN_EXITED = 1U;
+
       /** Runs the thread.
       *  @retval true if the thread was started successfully, 
       *  @retval false if the thread was not started successfully, or the thread was already running
       */
-      virtual bool run()
+      bool runImpl()
       {
         threadAttr_thread1 = {
           .name = namE,
@@ -60,6 +148,14 @@ class Thread : public ThreadInterface
           threadAttr_thread1.attr_bits = osThreadDetached;
         }
 
+        if (stackMemorY != NULL && controlBlocK != NULL)
+        {
+          threadAttr_thread1.cb_mem = controlBlocK;
+          threadAttr_thread1.cb_size = sizeof(ThreadControlBlock);
+          threadAttr_thread1.stack_mem = stackMemorY;
+        }
+
+        joinState = JOIN_NONE;
         thread1_id = osThreadNew(threadFunction, this, &threadAttr_thread1);
         
         return thread1_id ? true : false;
@@ -69,7 +165,7 @@ class Thread : public ThreadInterface
       *  @retval true if the thread is running
       *  @retval false if the thread is not running
       */
-      virtual bool isRunning()
+      bool isRunningImpl()
       {
         state = osThreadGetState(thread1_id);
         if ( state == osThreadReady  || state == osThreadRunning || state == osThreadBlocked )
@@ -84,20 +180,60 @@ class Thread : public ThreadInterface
         *  @retval true if the thread was successfully joined in the given time
         *  @retval false if the thread was not joined within the given time or the thread is not joinable at all
         */
-      virtual bool join(unsigned int timeout)
+      bool joinImpl(unsigned int timeout)
       {
-        if (joinablE == JOINABLE)
+        if ( joinablE != JOINABLE || thread1_id == NULL )
         {
-          return osOK == osSemaphoreAcquire(sid_Semaphore, timeout) ? true : false;
+          // never started or already joined, there is no thread to wait for
+          return false;
         }
-        return false;
+        uintptr_t state = joinState.load();
+        if ( state != JOIN_EXITED && timeout == 0U )
+        {
+          // tryJoin() on a running thread costs a single load
+          return false;
+        }
+        if ( state == JOIN_NONE )
+        {
+          // register for the thread flag set by the exiting thread, only one thread may join at a time
+          uintptr_t self = (uintptr_t)osThreadGetId();
+          if ( !joinState.compare_exchange_strong(state, self) && state != JOIN_EXITED )
+          {
+            return false;
+          }
+          Deadline left(timeout);
+          while ( ( state = joinState.load() ) != JOIN_EXITED )
+          {
+            unsigned int remaining = left.remaining();
+            if ( remaining == 0U )
+            {
+              if ( joinState.compare_exchange_strong(state, JOIN_NONE) )
+              {
+                return false;
+              }
+              break;
+            }
+            osThreadFlagsWait(OSAPI_JOIN_THREAD_FLAG, osFlagsWaitAny, msToTicks(remaining));
+          }
+          // the flag may have been set after the state was seen, don't leave it for the next join
+          osThreadFlagsClear(OSAPI_JOIN_THREAD_FLAG);
+        }
+        else if ( state != JOIN_EXITED )
+        {
+          return false;
+        }
+        // osThreadJoin() has no timeout, but the thread is past its last access to the object by now
+        osThreadJoin(thread1_id);
+        thread1_id = NULL;
+        joinState = JOIN_NONE;
+        return true;
       }
 
       /** Checks, if the thread is joinable.
         *  @retval true if the thread is joinable
         *  @retval false if the thread is not joinable
         */
-      virtual bool isJoinable()
+      bool isJoinableImpl()
       {
         return joinablE == JOINABLE ? true : false;
       }
@@ -106,7 +242,7 @@ class Thread : public ThreadInterface
         *  @retval true if the thread was suspended successfully
         *  @retval false if the thread was not suspended for some reason
         */
-      virtual bool suspend()
+      bool suspendImpl()
       {
         status = osThreadSuspend(	thread1_id );
         if ( status == osOK )
@@ -120,7 +256,7 @@ class Thread : public ThreadInterface
         *  @retval true if the thread was resumed successfully
         *  @retval false if the thread was not resumed for some reason
         */
-      virtual bool resume()
+      bool resumeImpl()
       {
         status = osThreadResume (	thread1_id	);
         if ( status == osOK )
@@ -135,7 +271,7 @@ class Thread : public ThreadInterface
         *  @retval true if the priority for the thread was set successfully
         *  @retval false if the priority for the thread was not set successfully for some reason
         */
-      virtual bool setPriority(int priority)
+      bool setPriorityImpl(int priority)
       {
         prioritY = priority;
         status = osThreadSetPriority(thread1_id, (osPriority_t) priority);
@@ -145,18 +281,62 @@ class Thread : public ThreadInterface
       /** Gets the thread priority
         *  @return current thread priority
         */
-      virtual int getPriority()
+      int getPriorityImpl()
       {
         return prioritY;
       }
       
+      /** Sets the thread affinity. RTX runs on a single core, so only masks containing core 0 are accepted.
+        *  @param[in] affinity mask of the allowed cores
+        *  @retval true if the mask contains core 0
+        *  @retval false otherwise
+        */
+      bool setAffinityImpl(AffinityMask affinity)
+      {
+        if ( ( affinity & 1ULL ) == 0ULL )
+        {
+          return false;
+        }
+        affinitY = affinity;
+        return true;
+      }
+
+      /** Gets the thread affinity.
+        *  @return the mask last set
+        */
+      AffinityMask getAffinityImpl()
+      {
+        return affinitY;
+      }
+
       /** Gets thread name
         *  @return name of the thread
         */
-      virtual const char* getName()
+      const char* getNameImpl()
       {
         return namE;
       }           
+
+      /** Reads the counters for the ThreadRegistry. RTX reports the state and the free stack space
+        *  (requires stack watermarking), it does not keep CPU time or context switches per thread.
+        *  @param[out] statistics receives the counters
+        */
+      void readStatisticsImpl(ThreadStatistics& statistics)
+      {
+        if ( thread1_id == NULL )
+        {
+          return;
+        }
+        switch ( osThreadGetState(thread1_id) )
+        {
+          case osThreadRunning: statistics.state = THREAD_RUNNING; break;
+          case osThreadReady: statistics.state = THREAD_READY; break;
+          case osThreadBlocked: statistics.state = THREAD_BLOCKED; break;
+          case osThreadTerminated: statistics.state = THREAD_TERMINATED; break;
+          default: break;
+        }
+        statistics.stackFree = osThreadGetStackSpace(thread1_id);
+      }
   
   protected:
       /** Delays thread execution for a given time.
@@ -167,17 +347,62 @@ class Thread : public ThreadInterface
         Thread* osapiThreadObject = reinterpret_cast<Thread*>(argument);
         if (osapiThreadObject) 
         {	
+          osapiThreadObject->enterRegistry();
           osapiThreadObject->job();
+          osapiThreadObject->leaveRegistry();
           if ( osapiThreadObject->joinablE == JOINABLE )
           {
-            osSemaphoreRelease(osapiThreadObject->sid_Semaphore);
+            // the joining thread may destroy the object as soon as it sees JOIN_EXITED, don't touch it afterwards
+            uintptr_t joiner = osapiThreadObject->joinState.exchange(JOIN_EXITED);
+            if ( joiner != JOIN_NONE )
+            {
+              osThreadFlagsSet((osThreadId_t)joiner, OSAPI_JOIN_THREAD_FLAG);
+            }
           }
         }				
         osThreadExit();
       }
   
-      virtual void sleep(unsigned int time) {
-        osDelay(time);
+      void sleepImpl(unsigned int time) {
+        osDelay(msToTicks(time));
+      }
+
+      /** Blocks the thread, called from its own job(), until it is woken up with sendWakeUp() or the deadline passes.
+        *  The wake-up is the thread flag OSAPI_WAKE_THREAD_FLAG, which stays set until it is taken here,
+        *  so the word is not needed to close the race with the waker. The wait ends on the first tick at or after
+        *  the deadline (see ticksUntil()), like osDelayUntil().
+        *  @param[in] word word changed by the waker
+        *  @param[in] expected value the word holds until the thread is to wake up
+        *  @param[in] until deadline of the wait
+        *  @retval true if the thread took the wake-up
+        *  @retval false if the deadline passed
+        */
+      bool waitForWakeUp(std::atomic<unsigned int>& word, unsigned int expected, const Deadline& until)
+      {
+        (void)word;
+        (void)expected;
+        while ( true )
+        {
+          uint32_t ticks = ticksUntil(until);
+          if ( ( osThreadFlagsWait(OSAPI_WAKE_THREAD_FLAG, osFlagsWaitAny, ticks) & osFlagsError ) == 0U )
+          {
+            return true;
+          }
+          if ( ticks == 0U )
+          {
+            return false;
+          }
+        }
+      }
+
+      /** Wakes up the thread blocked in waitForWakeUp(). Only to be called while the thread is known to wait,
+        *  the thread is gone as soon as it returned from job() and was joined.
+        *  @param[in] word word the thread waits on, changed by the caller before
+        */
+      void sendWakeUp(std::atomic<unsigned int>& word)
+      {
+        (void)word;
+        osThreadFlagsSet(thread1_id, OSAPI_WAKE_THREAD_FLAG);
       }
 
 };
@@ -0,0 +1,47 @@
+#ifndef OSAPI_TICKS_RTX_H
+#define OSAPI_TICKS_RTX_H
+
+#include "osapi.h"
+
+/** Converts a timeout in milliseconds into RTX kernel ticks. All timeouts of this library are in milliseconds.
+ *  Rounds up, so a wait never ends before the requested time; UINT_MAX maps to osWaitForever.
+ *  @param[in] timeout number of milliseconds
+ *  @return number of ticks
+ */
+inline uint32_t msToTicks(unsigned int timeout)
+{
+	if (timeout == UINT_MAX)
+	{
+		return osWaitForever;
+	}
+	unsigned long long ticks = ((unsigned long long)timeout * osKernelGetTickFreq() + 999ULL) / 1000ULL;
+	return ticks >= osWaitForever ? osWaitForever - 1U : (uint32_t)ticks;
+}
+
+/** Converts a deadline on the monotonicNanos() clock into the number of RTX kernel ticks to wait for it, so the wait
+ *  ends on the first tick at or after the deadline. monotonicNanos() follows the tick count, so a deadline on a tick
+ *  (e.g. a release time advanced by whole ticks) is met exactly instead of being rounded up to milliseconds.
+ *  @param[in] until deadline
+ *  @return number of ticks, 0 if the deadline passed, osWaitForever if it never expires
+ */
+inline uint32_t ticksUntil(const Deadline& until)
+{
+	if (until.isNever())
+	{
+		return osWaitForever;
+	}
+	unsigned long long expiry = until.getExpiry();
+	unsigned long long now = monotonicNanos();
+	if (now >= expiry)
+	{
+		return 0U;
+	}
+	// first tick at or after the deadline minus the current tick, split into seconds so nothing overflows
+	const unsigned long long frequency = osKernelGetTickFreq();
+	unsigned long long ticks = (expiry / 1000000000ULL - now / 1000000000ULL) * frequency
+		+ (expiry % 1000000000ULL * frequency + 999999999ULL) / 1000000000ULL
+		- now % 1000000000ULL * frequency / 1000000000ULL;
+	return ticks >= osWaitForever ? osWaitForever - 1U : (uint32_t)ticks;
+}
+
+#endif // OSAPI_TICKS_RTX_H
@@ -0,0 +1,110 @@
+#ifndef OSAPI_WAIT_QUEUE_RTX_H
+#define OSAPI_WAIT_QUEUE_RTX_H
+
+#include "osapi.h"
+
+#ifndef OSAPI_WAIT_QUEUE_MAX_WAITERS
+/** Maximum number of pending wake-ups kept by a single wait queue. */
+#define OSAPI_WAIT_QUEUE_MAX_WAITERS 32U
+#endif
+
+/** Lets threads block until a 32-bit word changes its value.
+ *  RTX has no address based waiting, so the waiters sleep on a counting semaphore instead.
+ *  A waker which changed the word releases the semaphore once per registered waiter; a stale token only
+ *  causes a spurious wake-up, which the callers handle by re-checking their condition.
+ *  The semaphore is created on first use, as static objects (e.g. an InternalLock inside a static SharedMutex)
+ *  are constructed before osKernelInitialize().
+ */
+class WaitQueue
+{
+private:
+	std::atomic<osSemaphoreId_t> sid_Semaphore;
+	std::atomic<unsigned int> waiters;
+
+	/** Gets the semaphore, creates it on the first call.
+	 *  @return the semaphore, NULL if the kernel can't create it yet
+	 */
+	osSemaphoreId_t semaphore()
+	{
+		osSemaphoreId_t current = sid_Semaphore.load(std::memory_order_acquire);
+		if (current == NULL)
+		{
+			osSemaphoreId_t created = osSemaphoreNew(OSAPI_WAIT_QUEUE_MAX_WAITERS, 0U, NULL);
+			if (created == NULL)
+			{
+				return NULL;
+			}
+			// threads creating it concurrently keep the first one published
+			if (sid_Semaphore.compare_exchange_strong(current, created, std::memory_order_acq_rel, std::memory_order_acquire))
+			{
+				return created;
+			}
+			osSemaphoreDelete(created);
+		}
+		return current;
+	}
+
+public:
+	WaitQueue() : sid_Semaphore(NULL), waiters(0U)
+	{
+	}
+
+	~WaitQueue()
+	{
+		osSemaphoreId_t current = sid_Semaphore.load();
+		if (current != NULL)
+		{
+			osSemaphoreDelete(current);
+		}
+	}
+
+	/** Blocks the calling thread as long as the word holds the expected value.
+	 *  May return spuriously, the caller always has to re-check its condition.
+	 *  @param[in] word watched word
+	 *  @param[in] expected value the word is expected to hold
+	 *  @param[in] timeout maximum number of milliseconds to block the calling thread
+	 *  @retval true if the thread was woken up or the word did not hold the expected value
+	 *  @retval false if the timeout expired
+	 */
+	bool wait(std::atomic<unsigned int>& word, unsigned int expected, unsigned int timeout)
+	{
+		bool woken = true;
+		// register first, so a waker that changes the word afterwards is guaranteed to see us
+		waiters.fetch_add(1U);
+		if ( word.load() == expected )
+		{
+			woken = osSemaphoreAcquire(semaphore(), msToTicks(timeout)) == osOK ? true : false;
+		}
+		waiters.fetch_sub(1U);
+		return woken;
+	}
+
+	/** Wakes up one thread waiting on the word. */
+	void wakeOne(std::atomic<unsigned int>& word)
+	{
+		(void)word;
+		if ( waiters.load() != 0U )
+		{
+			osSemaphoreRelease(semaphore());
+		}
+	}
+
+	/** Wakes up all threads waiting on the word. */
+	void wakeAll(std::atomic<unsigned int>& word)
+	{
+		(void)word;
+		unsigned int count = waiters.load();
+		if ( count == 0U )
+		{
+			return;
+		}
+		osSemaphoreId_t current = semaphore();
+		for ( ; count != 0U; count-- )
+		{
+			osSemaphoreRelease(current);
+		}
+	}
+
+};
+
+#endif // OSAPI_WAIT_QUEUE_RTX_H
@@ -0,0 +1,83 @@
+#ifndef OSAPI_EVENT_FLAGS_WINDOWS_H
+#define OSAPI_EVENT_FLAGS_WINDOWS_H
+
+/** Event flags kept in a single word, waiting threads block with WaitOnAddress. */
+class EventFlags : public EventFlagsInterface
+{
+	private:
+		std::atomic<unsigned int> flagS;
+		std::atomic<unsigned int> waiters;
+		WaitQueue queue;
+
+		static bool satisfied(unsigned int current, unsigned int flags, EventWait mode)
+		{
+			return ( mode == WAIT_ALL ) ? ( current & flags ) == flags : ( current & flags ) != 0U;
+		}
+
+	public:
+		EventFlags() : flagS(0U), waiters(0U)
+		{
+		}
+
+		virtual unsigned int set(unsigned int flags) final
+		{
+			unsigned int current = flagS.fetch_or(flags) | flags;
+			if ( waiters.load() != 0U )
+			{
+				queue.wakeAll(flagS);
+			}
+			return current;
+		}
+
+		virtual unsigned int clear(unsigned int flags) final
+		{
+			return flagS.fetch_and(~flags);
+		}
+
+		virtual unsigned int get() final
+		{
+			return flagS.load();
+		}
+
+		virtual unsigned int wait(unsigned int flags, EventWait mode, bool clearOnExit, unsigned int timeout) final
+		{
+			Deadline left(timeout);
+			bool registered = false;
+			unsigned int current = flagS.load();
+			while ( true )
+			{
+				if ( satisfied(current, flags, mode) )
+				{
+					if ( clearOnExit && !flagS.compare_exchange_weak(current, current & ~flags) )
+					{
+						continue;
+					}
+					break;
+				}
+				unsigned int remaining = left.remaining();
+				if ( remaining == 0U )
+				{
+					current = 0U;
+					break;
+				}
+				if ( !registered )
+				{
+					registered = true;
+					waiters.fetch_add(1U);
+				}
+				else
+				{
+					queue.wait(flagS, current, remaining);
+				}
+				current = flagS.load();
+			}
+			if ( registered )
+			{
+				waiters.fetch_sub(1U);
+			}
+			return current;
+		}
+
+};
+
+#endif // OSAPI_EVENT_FLAGS_WINDOWS_H
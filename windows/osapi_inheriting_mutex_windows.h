@@ -0,0 +1,50 @@
+#ifndef OSAPI_INHERITING_MUTEX_WINDOWS_H
+#define OSAPI_INHERITING_MUTEX_WINDOWS_H
+
+/** Mutex for code which requires priority inheritance.
+ *  Windows has no priority inheritance; the scheduler instead boosts threads that are ready but starved
+ *  for several seconds, which eventually lets a preempted owner release the mutex.
+ *  The type exists so portable code compiles, it behaves like Mutex.
+ */
+class InheritingMutex : public BasicMutex<InheritingMutex>
+{
+		friend class BasicMutex<InheritingMutex>;
+
+	private:
+		HANDLE mutex;
+
+	public:
+		/** Inheriting mutex constructor.
+		 *  @param[in] name optional name, reported by the mutex profiling (OSAPI_MUTEX_PROFILING)
+		 */
+		InheritingMutex(const char* name = nullptr) : BasicMutex<InheritingMutex>(name)
+		{
+			mutex = CreateSemaphore(NULL, 1, 1, NULL);
+		}
+
+		virtual ~InheritingMutex()
+		{
+			if (mutex != nullptr) CloseHandle(mutex);
+		}
+
+	private:
+		bool lockImpl(unsigned int timeout)
+		{
+			if(mutex != nullptr)
+			{
+				return WaitForSingleObject(mutex, timeout) == WAIT_OBJECT_0 ? true : false;
+			}
+			return false;
+		}
+
+		void unlockImpl()
+		{
+			if(mutex != nullptr)
+			{
+				ReleaseSemaphore(mutex, 1, NULL);
+			}
+		}
+
+};
+
+#endif // OSAPI_INHERITING_MUTEX_WINDOWS_H
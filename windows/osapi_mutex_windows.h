@@ -2,13 +2,18 @@
 #define OSAPI_MUTEX_WINDOWS_H
 
 
-class Mutex : public MutexInterface
+class Mutex : public BasicMutex<Mutex>
 {
+		friend class BasicMutex<Mutex>;
+
 	private:
 		HANDLE mutex;
 
 	public:
-		Mutex()
+		/** Mutex constructor.
+		 *  @param[in] name optional name, reported by the mutex profiling (OSAPI_MUTEX_PROFILING)
+		 */
+		Mutex(const char* name = nullptr) : BasicMutex<Mutex>(name)
 		{
 			mutex = CreateSemaphore(NULL, 1, 1, NULL);
 		}
@@ -18,7 +23,8 @@ class Mutex : public MutexInterface
 			if (mutex != nullptr) CloseHandle(mutex);
 		}
 
-		virtual bool lock(unsigned int timeout)
+	private:
+		bool lockImpl(unsigned int timeout)
 		{
 			if(mutex != nullptr)
 			{
@@ -27,7 +33,7 @@ class Mutex : public MutexInterface
 			return false;
 		}
 		
-		virtual void unlock()
+		void unlockImpl()
 		{
 			if(mutex != nullptr)
 			{
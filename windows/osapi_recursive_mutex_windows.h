@@ -1,13 +1,18 @@
 #ifndef OSAPI_RECURSIVE_MUTEX_WINDOWS_H
 #define OSAPI_RECURSIVE_MUTEX_WINDOWS_H
 
-class RecursiveMutex : public MutexInterface
+class RecursiveMutex : public BasicMutex<RecursiveMutex>
 {
+		friend class BasicMutex<RecursiveMutex>;
+
 	private:
 		HANDLE mutex;
 
 	public:
-		RecursiveMutex()
+		/** Recursive mutex constructor.
+		 *  @param[in] name optional name, reported by the mutex profiling (OSAPI_MUTEX_PROFILING)
+		 */
+		RecursiveMutex(const char* name = nullptr) : BasicMutex<RecursiveMutex>(name)
 		{
 			mutex = CreateMutex(NULL, TRUE, NULL);
 		}
@@ -16,7 +21,9 @@ class RecursiveMutex : public MutexInterface
 		{
 			if (mutex != nullptr) CloseHandle(mutex);
 		}
-		virtual bool lock(unsigned int timeout)
+
+	private:
+		bool lockImpl(unsigned int timeout)
 		{
 			if(mutex != nullptr)
 			{
@@ -25,7 +32,7 @@ class RecursiveMutex : public MutexInterface
 			return false;
 		}
 
-		virtual void unlock()
+		void unlockImpl()
 		{
 			if(mutex != nullptr)
 			{
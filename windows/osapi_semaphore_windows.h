@@ -0,0 +1,105 @@
+#ifndef OSAPI_SEMAPHORE_WINDOWS_H
+#define OSAPI_SEMAPHORE_WINDOWS_H
+
+/** Counting semaphore mapped onto a Windows semaphore object. */
+class Semaphore
+{
+	private:
+		HANDLE semaphore;
+
+	public:
+		/** Semaphore constructor.
+		 *  @param[in] initial initial count
+		 *  @param[in] max maximum count
+		 */
+		Semaphore(unsigned int initial, unsigned int max)
+		{
+			semaphore = CreateSemaphore(NULL, (LONG)(initial < max ? initial : max), (LONG)max, NULL);
+		}
+
+		~Semaphore()
+		{
+			if (semaphore != nullptr) CloseHandle(semaphore);
+		}
+
+		/** Decrements the count, if it is not zero.
+		 *  @retval true if the semaphore was acquired
+		 *  @retval false if the count was zero
+		 */
+		bool tryAcquire()
+		{
+			return acquire(0U);
+		}
+
+		/** Decrements the count. While it is zero, blocks the calling thread for the maximum given timeout.
+		 *  @param[in] timeout maximum number of milliseconds to block the calling thread
+		 *  @retval true if the semaphore was acquired
+		 *  @retval false if the semaphore was not acquired within the given time
+		 */
+		bool acquire(unsigned int timeout)
+		{
+			if(semaphore != nullptr)
+			{
+				return WaitForSingleObject(semaphore, timeout) == WAIT_OBJECT_0 ? true : false;
+			}
+			return false;
+		}
+
+		/** Increments the count and wakes up as many blocked threads.
+		 *  @param[in] n number of releases
+		 *  @retval true if the count was incremented
+		 *  @retval false if the count would exceed the maximum, the count is left unchanged
+		 */
+		bool release(unsigned int n = 1U)
+		{
+			if(semaphore != nullptr)
+			{
+				return ReleaseSemaphore(semaphore, (LONG)n, NULL) ? true : false;
+			}
+			return false;
+		}
+
+};
+
+/** Binary signal with a single waiting thread, mapped onto an auto-reset event.
+ *  post() may be called from any thread; posts made while the signal is already set are merged.
+ */
+class Signal
+{
+	private:
+		HANDLE event;
+
+	public:
+		Signal()
+		{
+			event = CreateEvent(NULL, FALSE, FALSE, NULL);
+		}
+
+		~Signal()
+		{
+			if (event != nullptr) CloseHandle(event);
+		}
+
+		/** Sets the signal and wakes up the waiting thread. */
+		void post()
+		{
+			if (event != nullptr) SetEvent(event);
+		}
+
+		/** Waits until the signal is set and clears it. Only one thread may wait at a time.
+		 *  @param[in] timeout maximum number of milliseconds to block the calling thread
+		 *  @retval true if the signal was set
+		 *  @retval false if the signal was not set within the given time
+		 */
+		bool wait(unsigned int timeout)
+		{
+			if(event != nullptr)
+			{
+				return WaitForSingleObject(event, timeout) == WAIT_OBJECT_0 ? true : false;
+			}
+			return false;
+		}
+
+};
+
+#endif // OSAPI_SEMAPHORE_WINDOWS_H
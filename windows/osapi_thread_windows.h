@@ -3,15 +3,41 @@
 
 #include "osapi.h"
 
+/** Placeholder for the thread control block memory, Windows always allocates its own. */
+struct ThreadControlBlock
+{
+};
+
+/** Maps the portable priority levels to the THREAD_PRIORITY_* values, see Priority.
+ *  @param[in] priority portable priority level
+ *  @return priority for SetThreadPriority()
+ */
+inline int nativePriority(Priority priority)
+{
+	switch (priority)
+	{
+		case PRIORITY_IDLE: return THREAD_PRIORITY_IDLE;
+		case PRIORITY_LOW: return THREAD_PRIORITY_LOWEST;
+		case PRIORITY_BELOW_NORMAL: return THREAD_PRIORITY_BELOW_NORMAL;
+		case PRIORITY_ABOVE_NORMAL: return THREAD_PRIORITY_ABOVE_NORMAL;
+		case PRIORITY_HIGH: return THREAD_PRIORITY_HIGHEST;
+		case PRIORITY_REALTIME: return THREAD_PRIORITY_TIME_CRITICAL;
+		default: return THREAD_PRIORITY_NORMAL;
+	}
+}
+
 /** Thread interface implementation for Windows. */
-class Thread : public ThreadInterface
+class Thread : public BasicThread<Thread>
 {
+        friend class BasicThread<Thread>;
+
     private:
         HANDLE threadHandler;
         bool joinablE;
         const char* namE;
         unsigned int stackSizE;
         int prioritY;
+        AffinityMask affinitY;
         bool running;
 
     public:
@@ -26,11 +52,50 @@ class Thread : public ThreadInterface
 			namE = name;
 			stackSizE = stackSize;
 			prioritY = priority;
+			affinitY = ANY_CPU;
 			running = false;
 
 			joinablE = ( isJoinable == JOINABLE ) ? true : false;
 			threadHandler = nullptr;
         }
+
+        /** Thread constructor for statically allocated threads.
+         *  Windows can't run a thread on a caller provided stack, so the memory is ignored
+         *  and the thread is created like with the other constructor.
+         *  @param[in] priority thread priority
+         *  @param[in] stackSize thread stack size in bytes
+         *  @param[in] isJoinable decides if the thread supports join operation or not
+         *  @param[in] stackMemory memory for the thread stack (unused)
+         *  @param[in] controlBlock memory for the thread control block (unused)
+         *  @param[in] name optional thread name
+         */
+        Thread(int priority, unsigned int stackSize, Joinable isJoinable, void* stackMemory, ThreadControlBlock* controlBlock, const char* name = "unnamed")
+            : Thread(priority, stackSize, isJoinable, name)
+        {
+			(void)stackMemory;
+			(void)controlBlock;
+        }
+
+        /** Thread constructor taking a portable priority level, mapped with nativePriority(). */
+        Thread(Priority priority, unsigned int stackSize, Joinable isJoinable, const char* name = "unnamed")
+            : Thread(nativePriority(priority), stackSize, isJoinable, name)
+        {
+        }
+
+        /** Constructor for statically allocated threads taking a portable priority level, mapped with nativePriority(). */
+        Thread(Priority priority, unsigned int stackSize, Joinable isJoinable, void* stackMemory, ThreadControlBlock* controlBlock, const char* name = "unnamed")
+            : Thread(nativePriority(priority), stackSize, isJoinable, stackMemory, controlBlock, name)
+        {
+        }
+
+        /** Thread constructor taking all creation parameters at once.
+         *  @param[in] attributes priority, stack size, joinability, name and affinity of the thread
+         */
+        Thread(const ThreadAttributes& attributes)
+            : Thread(attributes.priority, attributes.stackSize, attributes.joinable, attributes.name)
+        {
+			affinitY = attributes.affinity;
+        }
         
         /** Virtual destructor required to properly destroy derived class objects. */
         virtual ~Thread()
@@ -38,19 +103,37 @@ class Thread : public ThreadInterface
         	CloseHandle(threadHandler);
         }
         
+    private:
+
         /** Runs the thread.
          *  @retval true if the thread was started successfully, 
          *  @retval false if the thread was not started successfully, or the thread was already running
          */
-        virtual bool run()
+        bool runImpl()
         { 
         	if (!running)
         	{
-				threadHandler = CreateThread(NULL, stackSizE, threadFunction, (LPVOID)this, 0, NULL);
+				DWORD_PTR mask = 0;
+				if (affinitY != ANY_CPU && (mask = allowedMask(affinitY)) == 0)
+				{
+					// no processor of the mask is available to the process
+					return false;
+				}
+				// created suspended, so the affinity applies before the thread runs
+				threadHandler = CreateThread(NULL, stackSizE, threadFunction, (LPVOID)this, CREATE_SUSPENDED, NULL);
 				if (threadHandler)
 				{
+					if (mask != 0 && SetThreadAffinityMask(threadHandler, mask) == 0)
+					{
+						// the thread never ran, discard it
+						TerminateThread(threadHandler, 0);
+						CloseHandle(threadHandler);
+						threadHandler = nullptr;
+						return false;
+					}
 					SetThreadPriority(threadHandler, prioritY);
 					running = true;
+					ResumeThread(threadHandler);
 					return true;
 				}
         	}
@@ -61,7 +144,7 @@ class Thread : public ThreadInterface
          *  @retval true if the thread is running
          *  @retval false if the thread is not running
          */
-        virtual bool isRunning()
+        bool isRunningImpl()
         { 
         	return (threadHandler != nullptr) ? running : false;
         }   
@@ -71,7 +154,7 @@ class Thread : public ThreadInterface
          *  @retval true if the thread was successfully joined in the given time
          *  @retval false if the thread was not joined within the given time or the thread is not joinable at all
          */
-        virtual bool join(unsigned int timeout)
+        bool joinImpl(unsigned int timeout)
         {
         	if (joinablE)
         	{
@@ -89,7 +172,7 @@ class Thread : public ThreadInterface
          *  @retval true if the thread is joinable
          *  @retval false if the thread is not joinable
          */
-        virtual bool isJoinable()
+        bool isJoinableImpl()
         {
         	return joinablE;
         }
@@ -98,7 +181,7 @@ class Thread : public ThreadInterface
          *  @retval true if the thread was suspended successfully
          *  @retval false if the thread was not suspended for some reason
          */
-        virtual bool suspend()
+        bool suspendImpl()
         {
         	if (running)
         	{
@@ -112,7 +195,7 @@ class Thread : public ThreadInterface
          *  @retval true if the thread was resumed successfully
          *  @retval false if the thread was not resumed for some reason
          */
-        virtual bool resume()
+        bool resumeImpl()
         {
         	if (!running)
         	{
@@ -127,7 +210,7 @@ class Thread : public ThreadInterface
          *  @retval true if the priority for the thread was set successfully
          *  @retval false if the priority for the thread was not set successfully for some reason
          */
-        virtual bool setPriority(int priority)
+        bool setPriorityImpl(int priority)
         {
         	prioritY = priority;
         	return SetThreadPriority(threadHandler, prioritY) != 0 ? true : false;
@@ -136,18 +219,80 @@ class Thread : public ThreadInterface
         /** Gets the thread priority
          *  @return current thread priority
          */
-        virtual int getPriority()
+        int getPriorityImpl()
         {
         	return prioritY;
         }
         
+        /** Restricts the thread to a set of logical processors with SetThreadAffinityMask().
+         *  @param[in] affinity mask of the allowed processors (of the processor group of the thread), ANY_CPU removes the restriction
+         *  @retval true if the affinity was set successfully (or stored for the next run())
+         *  @retval false if the mask does not contain any processor of the process
+         */
+        bool setAffinityImpl(AffinityMask affinity)
+        {
+        	DWORD_PTR mask = allowedMask(affinity);
+        	if (mask == 0)
+        	{
+        		return false;
+        	}
+        	if (threadHandler != nullptr && running && SetThreadAffinityMask(threadHandler, mask) == 0)
+        	{
+        		return false;
+        	}
+        	affinitY = affinity;
+        	return true;
+        }
+
+        /** Gets the set of processors the thread may run on. Windows can't query the mask of a thread,
+         *  so this is the mask last set.
+         *  @return mask of the allowed processors
+         */
+        AffinityMask getAffinityImpl()
+        {
+        	return affinitY;
+        }
+
+        /** Intersects an affinity mask with the processors available to the process.
+         *  @param[in] affinity mask of the processors, ANY_CPU for all of them
+         *  @return mask of the processors the thread may run on, 0 if none is left or the process mask is unknown
+         */
+        static DWORD_PTR allowedMask(AffinityMask affinity)
+        {
+        	DWORD_PTR processMask, systemMask;
+        	if (!GetProcessAffinityMask(GetCurrentProcess(), &processMask, &systemMask))
+        	{
+        		return 0;
+        	}
+        	return (affinity == ANY_CPU) ? processMask : ((DWORD_PTR)affinity & processMask);
+        }
+
         /** Gets thread name
          *  @return name of the thread
          */
-        virtual const char* getName()
+        const char* getNameImpl()
         {
             return namE;
         }
+
+        /** Reads the counters for the ThreadRegistry. Windows reports the CPU time (kernel and user),
+         *  it does not expose the scheduling state or context switches through the thread handle.
+         *  @param[out] statistics receives the counters
+         */
+        void readStatisticsImpl(ThreadStatistics& statistics)
+        {
+            FILETIME creation, exit, kernel, user;
+            if ( threadHandler != nullptr && GetThreadTimes(threadHandler, &creation, &exit, &kernel, &user) )
+            {
+                ULARGE_INTEGER kernelTime, userTime;
+                kernelTime.LowPart = kernel.dwLowDateTime;
+                kernelTime.HighPart = kernel.dwHighDateTime;
+                userTime.LowPart = user.dwLowDateTime;
+                userTime.HighPart = user.dwHighDateTime;
+                // FILETIME counts 100 ns intervals
+                statistics.cpuTime = (kernelTime.QuadPart + userTime.QuadPart) * 100ULL;
+            }
+        }
     
     protected:
         static DWORD WINAPI threadFunction(LPVOID argument)
@@ -155,18 +300,52 @@ class Thread : public ThreadInterface
         	Thread* osapiThreadObject = reinterpret_cast<Thread*>(argument);
         	if (osapiThreadObject)
         	{
+        		osapiThreadObject->enterRegistry();
         		osapiThreadObject->job();
+        		osapiThreadObject->leaveRegistry();
         	}
+        	return 0;
         }
 
         /** Delays thread execution for a given time.
          *  @param time[in] number of milliseconds to delay thread execution
          */
-        virtual void sleep(unsigned int time)
+        void sleepImpl(unsigned int time)
         {
         	Sleep(time);
         }
 
+        /** Blocks the thread, called from its own job(), while the word holds the expected value, until it is woken up
+         *  with sendWakeUp() or the deadline passes. The waker changes the word before it calls sendWakeUp().
+         *  WaitOnAddress() takes milliseconds, so the wait ends up to a millisecond after the deadline.
+         *  @param[in] word word changed by the waker
+         *  @param[in] expected value the word holds until the thread is to wake up
+         *  @param[in] until deadline of the wait
+         *  @retval true if the thread was woken up
+         *  @retval false if the deadline passed
+         */
+        bool waitForWakeUp(std::atomic<unsigned int>& word, unsigned int expected, const Deadline& until)
+        {
+        	while (word.load() == expected)
+        	{
+        		unsigned int remaining = until.remaining();
+        		if (remaining == 0U)
+        		{
+        			return false;
+        		}
+        		WaitOnAddress(&word, &expected, sizeof(expected), remaining);
+        	}
+        	return true;
+        }
+
+        /** Wakes up the thread blocked in waitForWakeUp() on the word.
+         *  @param[in] word word the thread waits on, changed by the caller before
+         */
+        void sendWakeUp(std::atomic<unsigned int>& word)
+        {
+        	WakeByAddressSingle(&word);
+        }
+
 };
 
 #endif /* OSAPI_THREAD_WINDOWS_H */
@@ -0,0 +1,43 @@
+#ifndef OSAPI_WAIT_QUEUE_WINDOWS_H
+#define OSAPI_WAIT_QUEUE_WINDOWS_H
+
+#ifdef _MSC_VER
+#pragma comment(lib, "Synchronization.lib")
+#endif
+
+/** Lets threads block until a 32-bit word changes its value. Maps onto WaitOnAddress (Windows 8 and newer). */
+class WaitQueue
+{
+	public:
+		/** Blocks the calling thread as long as the word holds the expected value.
+		 *  May return spuriously, the caller always has to re-check its condition.
+		 *  @param[in] word watched word
+		 *  @param[in] expected value the word is expected to hold
+		 *  @param[in] timeout maximum number of milliseconds to block the calling thread
+		 *  @retval true if the thread was woken up or the word did not hold the expected value
+		 *  @retval false if the timeout expired
+		 */
+		bool wait(std::atomic<unsigned int>& word, unsigned int expected, unsigned int timeout)
+		{
+			if ( WaitOnAddress(&word, &expected, sizeof(expected), timeout) )
+			{
+				return true;
+			}
+			return GetLastError() == ERROR_TIMEOUT ? false : true;
+		}
+
+		/** Wakes up one thread waiting on the word. */
+		void wakeOne(std::atomic<unsigned int>& word)
+		{
+			WakeByAddressSingle(&word);
+		}
+
+		/** Wakes up all threads waiting on the word. */
+		void wakeAll(std::atomic<unsigned int>& word)
+		{
+			WakeByAddressAll(&word);
+		}
+
+};
+
+#endif // OSAPI_WAIT_QUEUE_WINDOWS_H
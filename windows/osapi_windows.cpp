@@ -6,4 +6,79 @@ unsigned int getSystemTime() {
 	return GetTickCount();
 }
 
+unsigned int getSystemTimeMs() {
+	return GetTickCount();
+}
+
+unsigned long long ticksToNanos(unsigned int ticks) {
+	return (unsigned long long)ticks * 1000000ULL;
+}
+
+unsigned long long monotonicNanos() {
+	static LARGE_INTEGER frequency = { 0 };
+	if (frequency.QuadPart == 0) {
+		QueryPerformanceFrequency(&frequency);
+	}
+	LARGE_INTEGER counter;
+	QueryPerformanceCounter(&counter);
+	unsigned long long count = (unsigned long long)counter.QuadPart;
+	unsigned long long rate = (unsigned long long)frequency.QuadPart;
+	return count / rate * 1000000000ULL + count % rate * 1000000000ULL / rate;
+}
+
+unsigned int currentThreadIndex() {
+	static std::atomic<unsigned int> next(0U);
+	thread_local unsigned int index = next.fetch_add(1U, std::memory_order_relaxed);
+	return index;
+}
+
+unsigned int getPhysicalCores(AffinityMask* cores, unsigned int max) {
+	DWORD length = 0;
+	GetLogicalProcessorInformation(NULL, &length);
+	SYSTEM_LOGICAL_PROCESSOR_INFORMATION* information = (SYSTEM_LOGICAL_PROCESSOR_INFORMATION*)malloc(length);
+	if (information == NULL) {
+		return 0U;
+	}
+	const unsigned int maxCores = sizeof(AffinityMask) * CHAR_BIT;
+	AffinityMask coreMasks[maxCores];
+	AffinityMask packageMasks[maxCores];
+	unsigned int found = 0U;
+	unsigned int packages = 0U;
+	if (GetLogicalProcessorInformation(information, &length)) {
+		for (DWORD i = 0; i < length / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION); i++) {
+			if (information[i].Relationship == RelationProcessorCore && found < maxCores) {
+				coreMasks[found++] = (AffinityMask)information[i].ProcessorMask;
+			}
+			else if (information[i].Relationship == RelationProcessorPackage && packages < maxCores) {
+				packageMasks[packages++] = (AffinityMask)information[i].ProcessorMask;
+			}
+		}
+	}
+	free(information);
+
+	// interleave the packages: the first core of every package, then the second one of every package, ...
+	unsigned int rank[maxCores];
+	for (unsigned int i = 0U; i < found; i++) {
+		rank[i] = 0U;
+		for (unsigned int p = 0U; p < packages; p++) {
+			if ((coreMasks[i] & packageMasks[p]) != 0ULL) {
+				for (unsigned int j = 0U; j < i; j++) {
+					if ((coreMasks[j] & packageMasks[p]) != 0ULL) {
+						rank[i]++;
+					}
+				}
+			}
+		}
+	}
+	unsigned int stored = 0U;
+	for (unsigned int round = 0U; stored < found && stored < max; round++) {
+		for (unsigned int i = 0U; i < found && stored < max; i++) {
+			if (rank[i] == round) {
+				cores[stored++] = coreMasks[i];
+			}
+		}
+	}
+	return stored;
+}
+
 } // namespace osapi